@@ -0,0 +1,318 @@
+/**
+ * @file lexbench.c
+ * @brief Lexer throughput benchmark and synthetic Decaf source generator
+ *
+ * Each workload generates a Decaf source of a given size with a given mix of
+ * token kinds, lexes it repeatedly with @ref lex_text, and reports the best
+ * throughput in MB/s and tokens/s. Results can be written to (or checked
+ * against) a baseline file with one line per workload:
+ *
+ *     <workload> <MB/s> <tokens/s>
+ *
+ * Run "make bench" to check the checked-in baseline (bench/baseline.txt) and
+ * "make bench-baseline" to regenerate it.
+ */
+#include <time.h>
+
+#include "p1-lexer.h"
+
+/**
+ * @brief Error message buffer
+ */
+char decaf_error_msg[MAX_ERROR_LEN];
+
+/**
+ * @brief Data structure used by @c setjmp / @c longjmp for exception handling
+ */
+jmp_buf decaf_error;
+
+void Error_throw_printf (const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vsnprintf(decaf_error_msg, MAX_ERROR_LEN, format, args);
+    va_end(args);
+    longjmp(decaf_error, 1);
+}
+
+/**
+ * @brief Kinds of generated tokens
+ */
+typedef enum GenKind
+{
+    GEN_ID, GEN_HEX, GEN_DEC, GEN_STR, GEN_COMMENT, GEN_SYM, NUM_GEN_KINDS
+} GenKind;
+
+/**
+ * @brief Named token mix (relative weights of each @ref GenKind)
+ */
+typedef struct Workload
+{
+    const char* name;                   /**< @brief Name used in reports and baselines */
+    int weights[NUM_GEN_KINDS];         /**< @brief Relative frequency of each kind */
+} Workload;
+
+/**
+ * @brief Standard workloads (order: id, hex, dec, str, comment, sym)
+ */
+Workload workloads[] = {
+    { "mixed",       { 35,  5, 10,  5,  5, 40 } },
+    { "identifiers", { 90,  0,  0,  0,  0, 10 } },
+    { "literals",    { 10, 40, 40,  0,  0, 10 } },
+    { "strings",     { 20,  0,  0, 70,  0, 10 } },
+    { "comments",    { 20,  0,  0,  0, 70, 10 } },
+    { "operators",   { 20,  0,  5,  0,  0, 75 } },
+};
+
+/**
+ * @brief Number of standard workloads
+ */
+#define NUM_WORKLOADS (sizeof(workloads) / sizeof(workloads[0]))
+
+/**
+ * @brief Valid Decaf symbols
+ */
+const char* symbols[] = {
+    "(", ")", "[", "]", "{", "}", ";", "=", "==", "!=", "<=", ">=",
+    "+", "-", "*", "%", "\\"
+};
+
+/**
+ * @brief Append a random string of characters from a set
+ */
+char* gen_chars (char* p, const char* set, int min, int max)
+{
+    size_t set_len = strlen(set);
+    int len = min + rand() % (max - min + 1);
+    for (int i = 0; i < len; i++) {
+        *p++ = set[rand() % set_len];
+    }
+    return p;
+}
+
+/**
+ * @brief Generate a Decaf source of approximately the given size
+ *
+ * Identifiers all begin with 'x' so that none of them are keywords or reserved
+ * words, and lines are broken (and indented) every few tokens.
+ *
+ * @param size Target size in bytes
+ * @param weights Relative frequency of each token kind
+ * @param length Set to the actual size
+ * @returns Generated text (NUL-terminated; caller must free)
+ */
+char* generate (size_t size, const int* weights, size_t* length)
+{
+    int total = 0;
+    for (int k = 0; k < NUM_GEN_KINDS; k++) {
+        total += weights[k];
+    }
+    char* text = (char*)malloc(size + 256);
+    CHECK_MALLOC_PTR(text)
+    char* p = text;
+    int on_line = 0;
+    while ((size_t)(p - text) < size) {
+        int r = rand() % total;
+        GenKind kind = 0;
+        while (r >= weights[kind]) {
+            r -= weights[kind++];
+        }
+        switch (kind) {
+            case GEN_ID:
+                *p++ = 'x';
+                p = gen_chars(p, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_", 0, 11);
+                break;
+            case GEN_HEX:
+                *p++ = '0'; *p++ = 'x';
+                p = gen_chars(p, "0123456789abcdefABCDEF", 1, 8);
+                break;
+            case GEN_DEC:
+                p = gen_chars(p, "123456789", 1, 1);
+                p = gen_chars(p, "0123456789", 0, 8);
+                break;
+            case GEN_STR:
+                *p++ = '"';
+                p = gen_chars(p, "abcdefghijklmnopqrstuvwxyz     ,.!?", 0, 60);
+                *p++ = '"';
+                break;
+            case GEN_COMMENT:
+                *p++ = '/'; *p++ = '/'; *p++ = ' ';
+                p = gen_chars(p, "abcdefghijklmnopqrstuvwxyz     ", 0, 70);
+                on_line = 10;       /* force a line break */
+                break;
+            default: {
+                const char* sym = symbols[rand() % (sizeof(symbols) / sizeof(symbols[0]))];
+                size_t len = strlen(sym);
+                memcpy(p, sym, len);
+                p += len;
+                break;
+            }
+        }
+        if (++on_line >= 10) {
+            *p++ = '\n';
+            p = gen_chars(p, " ", 0, 8);
+            on_line = 0;
+        } else {
+            *p++ = ' ';
+        }
+    }
+    *p = '\0';
+    *length = p - text;
+    return text;
+}
+
+/**
+ * @brief Get the current wall clock time in seconds
+ */
+double wall_time (void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Look up a workload's throughput in a baseline file
+ *
+ * @returns False if the file or workload is missing
+ */
+bool read_baseline (const char* filename, const char* name, double* mb_per_sec, double* tok_per_sec)
+{
+    FILE* file = fopen(filename, "r");
+    if (file == NULL) {
+        return false;
+    }
+    char line[256], found[64];
+    bool ok = false;
+    while (!ok && fgets(line, sizeof(line), file) != NULL) {
+        ok = line[0] != '#' &&
+             sscanf(line, "%63s %lf %lf", found, mb_per_sec, tok_per_sec) == 3 &&
+             strcmp(found, name) == 0;
+    }
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Print usage information
+ *
+ * @param program Executable name
+ */
+void print_usage (const char* program)
+{
+    fprintf(stderr, "Usage: %s [-s <bytes>] [-r <repetitions>] [-w <workload>] [--seed <n>]\n"
+                    "       [--check <baseline> [--tolerance <fraction>] | --write <baseline>]\n"
+                    "       %s --generate [-s <bytes>] [-w <workload>] [--seed <n>]\n",
+            program, program);
+}
+
+int main (int argc, char** argv)
+{
+    size_t size = 4 << 20;
+    int reps = 5;
+    unsigned seed = 432;
+    double tolerance = 0.25;
+    const char* only = NULL;
+    const char* check_file = NULL;
+    const char* write_file = NULL;
+    bool generate_only = false;
+    for (int i = 1; i < argc; i++) {
+        bool has_arg = (i + 1 < argc);
+        if (strcmp(argv[i], "-s") == 0 && has_arg) {
+            size = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-r") == 0 && has_arg) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && has_arg) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && has_arg) {
+            seed = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--check") == 0 && has_arg) {
+            check_file = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && has_arg) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--write") == 0 && has_arg) {
+            write_file = argv[++i];
+        } else if (strcmp(argv[i], "--generate") == 0) {
+            generate_only = true;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    FILE* baseline = NULL;
+    if (write_file != NULL) {
+        baseline = fopen(write_file, "w");
+        if (baseline == NULL) {
+            fprintf(stderr, "Could not write file: %s\n", write_file);
+            return EXIT_FAILURE;
+        }
+        fprintf(baseline, "# lexer throughput baseline (%zu-byte inputs, best of %d runs)\n"
+                          "# workload MB/s tokens/s\n", size, reps);
+    }
+
+    bool regressed = false;
+    bool found = false;
+    if (!generate_only) {
+        printf("%-12s %10s %10s %12s %10s\n", "WORKLOAD", "BYTES", "MB/s", "TOKENS/s", "BASELINE");
+    }
+    for (size_t w = 0; w < NUM_WORKLOADS; w++) {
+        Workload* workload = &workloads[w];
+        if (only != NULL && strcmp(only, workload->name) != 0) {
+            continue;
+        }
+        found = true;
+        srand(seed);
+        size_t length;
+        char* text = generate(size, workload->weights, &length);
+        if (generate_only) {
+            fwrite(text, 1, length, stdout);
+            free(text);
+            break;
+        }
+
+        /* lex repeatedly and keep the best time */
+        double best = -1.0;
+        size_t num_tokens = 0;
+        for (int r = 0; r < reps; r++) {
+            if (setjmp(decaf_error) != 0) {
+                fprintf(stderr, "%s: %s\n", workload->name, decaf_error_msg);
+                return EXIT_FAILURE;
+            }
+            double start = wall_time();
+            TokenQueue* tokens = lex_text(text, length);
+            double elapsed = wall_time() - start;
+            num_tokens = TokenQueue_size(tokens);
+            TokenQueue_free(tokens);
+            if (best < 0.0 || elapsed < best) {
+                best = elapsed;
+            }
+        }
+        free(text);
+        double mb_per_sec = (double)length / best / 1e6;
+        double tok_per_sec = (double)num_tokens / best;
+        printf("%-12s %10zu %10.1f %12.0f", workload->name, length, mb_per_sec, tok_per_sec);
+
+        /* compare to (or record) the baseline */
+        double base_mb, base_tok;
+        if (check_file != NULL && read_baseline(check_file, workload->name, &base_mb, &base_tok)) {
+            bool slow = mb_per_sec < base_mb * (1.0 - tolerance);
+            printf(" %9.1f%s", base_mb, (slow ? "  REGRESSION" : ""));
+            regressed = regressed || slow;
+        } else if (check_file != NULL) {
+            printf(" %10s", "(none)");
+        }
+        printf("\n");
+        if (baseline != NULL) {
+            fprintf(baseline, "%-12s %.1f %.0f\n", workload->name, mb_per_sec, tok_per_sec);
+        }
+    }
+    if (baseline != NULL) {
+        fclose(baseline);
+    }
+    if (!found) {
+        fprintf(stderr, "Unknown workload: %s\n", only);
+        return EXIT_FAILURE;
+    }
+    return (regressed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -8,13 +8,68 @@
 
 #include "common.h"
 #include "token.h"
+#include "scanner.h"
+
+/**
+ * @brief Convert a Decaf program into a queue of tokens using multiple threads
+ *
+ * The text is split into one chunk per thread at newline boundaries, and each
+ * chunk is scanned in parallel as if it did not begin inside a string literal.
+ * The chunks are then stitched together in order: line numbers are shifted by
+ * the number of lines in the preceding chunks, and any chunk that actually
+ * began inside a string literal (or whose last string literal continues into
+ * the next chunk) is scanned again serially. The result (including any error
+ * thrown) is identical to @ref lex_text. The chunks are scanned by a pool of
+ * worker threads that persists between calls (see @ref lex_parallel_shutdown).
+ *
+ * @param text Input text
+ * @param length Length of the input text
+ * @param num_threads Number of threads to use (zero or negative means one per
+ * online processor)
+ * @returns Queue of tokens
+ */
+TokenQueue* lex_parallel (const char* text, size_t length, int num_threads);
+
+/**
+ * @brief Stop and join the worker threads used by @ref lex_parallel
+ *
+ * Later calls to @ref lex_parallel start new workers as needed.
+ */
+void lex_parallel_shutdown (void);
 
 /**
  * @brief Convert a string containing a Decaf program into a queue of tokens.
  *
+ * This is a single-pass, switch-based scanner that runs in time linear in the
+ * length of the text.
+ *
  * @param text String to lex
  * @returns Newly-created queue of tokens
  */
 TokenQueue* lex(const char* text);
 
+/**
+ * @brief Convert text of a given length into a queue of tokens.
+ *
+ * Same as @ref lex, but the text need not be NUL-terminated (e.g., a memory
+ * mapped file).
+ *
+ * @param text Text to lex
+ * @param length Length of the text
+ * @returns Newly-created queue of tokens
+ */
+TokenQueue* lex_text(const char* text, size_t length);
+
+/**
+ * @brief Convert a string into a queue of tokens using POSIX regular expressions.
+ *
+ * This is the original regex-cascade lexer. It produces the same tokens and
+ * errors as @ref lex (but may take quadratic time) and is kept for
+ * differential testing.
+ *
+ * @param text String to lex
+ * @returns Newly-created queue of tokens
+ */
+TokenQueue* lex_regex(const char* text);
+
 #endif
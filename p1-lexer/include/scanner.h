@@ -0,0 +1,199 @@
+/**
+ * @file scanner.h
+ * @brief Single-pass scanner and pull-based lexer
+ *
+ * Shared by the source-built lexer (see p1-lexer.h) and parser (see
+ * @ref parse_stream in p2-parser.h).
+ */
+
+#ifndef __SCANNER_H
+#define __SCANNER_H
+
+#include "common.h"
+#include "token.h"
+
+/**
+ * @brief Errors detected by the scanner
+ */
+typedef enum LexError
+{
+    LEX_OK,                 /**< @brief No error */
+    LEX_INVALID_TOKEN,      /**< @brief Text that does not start any token */
+    LEX_RESERVED_WORD       /**< @brief Reserved word used as an identifier */
+} LexError;
+
+/**
+ * @brief Token rules followed by the scanner
+ *
+ * The precompiled lexer used by the later projects accepts a few more tokens
+ * than @ref lex: the symbols @c , @c / @c < @c > @c ! @c && and @c || (but not
+ * @c \\), and carriage returns as whitespace. Its string literals end at the
+ * line and may only contain the escapes @c \\n @c \\t @c \\" and @c \\\\, a
+ * hex literal whose first digit is zero ends after that digit, and its error
+ * messages quote the offending text.
+ */
+typedef enum LexDialect
+{
+    LEX_PROJECT1,           /**< @brief Same tokens and errors as @ref lex (default) */
+    LEX_DECAF               /**< @brief Same tokens and errors as the precompiled lexer */
+} LexDialect;
+
+/**
+ * @brief Scanner state for producing token spans one at a time
+ *
+ * Initialize with @ref Scanner_init and call @ref Scanner_next repeatedly.
+ * Tokens are returned as @ref TokenSpan values that refer to the input text,
+ * so no token text is copied unless the caller asks for it.
+ */
+typedef struct Scanner
+{
+    const char* text;   /**< @brief Input text (need not be NUL-terminated) */
+    size_t length;      /**< @brief Length of the input text */
+    size_t pos;         /**< @brief Offset of the next unscanned character */
+    int line;           /**< @brief Current line number */
+    size_t line_start;  /**< @brief Offset of the first character on the current line */
+    LexError error;     /**< @brief Error found by @ref Scanner_try_next (if any) */
+    LexDialect dialect; /**< @brief Token rules to follow */
+} Scanner;
+
+/**
+ * @brief Prepare a scanner to read from the beginning of some text
+ *
+ * The scanner follows the @ref LEX_PROJECT1 rules unless its @c dialect is
+ * changed before the first token is scanned.
+ *
+ * @param scanner Scanner to initialize
+ * @param text Input text
+ * @param length Length of the input text
+ */
+void Scanner_init (Scanner* scanner, const char* text, size_t length);
+
+/**
+ * @brief Scan the next token without throwing errors
+ *
+ * This is safe to call from any thread. If the input contains an invalid token
+ * or a reserved word, the @c error field is set, @c pos is left at the start
+ * of the offending text, and @c line is its line number.
+ *
+ * @param scanner Scanner to advance
+ * @param span Destination for the scanned token
+ * @returns False if there are no more tokens or an error was found
+ */
+bool Scanner_try_next (Scanner* scanner, TokenSpan* span);
+
+/**
+ * @brief Throw the error recorded by @ref Scanner_try_next (if any)
+ *
+ * @param scanner Scanner that stopped
+ */
+void Scanner_throw_error (Scanner* scanner);
+
+/**
+ * @brief Scan the next token
+ *
+ * Throws an error (using the same messages as @ref lex) if the input contains
+ * an invalid token or a reserved word.
+ *
+ * @param scanner Scanner to advance
+ * @param span Destination for the scanned token
+ * @returns False if there are no more tokens
+ */
+bool Scanner_next (Scanner* scanner, TokenSpan* span);
+
+/**
+ * @brief Maximum lookahead supported by @ref Lexer_peek_span
+ */
+#define LEXER_LOOKAHEAD 4
+
+/**
+ * @brief Pull-based lexer that produces tokens on demand
+ *
+ * Only a small window of scanned token spans is held at any time, so memory
+ * use does not depend on the size of the input. Token text is only copied
+ * when a @ref Token is asked for.
+ *
+ * Allocate with @ref Lexer_new and de-allocate with @ref Lexer_free.
+ *
+ * Methods:
+ * - @ref Lexer_peek_span
+ * - @ref Lexer_next_span
+ * - @ref Lexer_peek
+ * - @ref Lexer_next
+ */
+typedef struct Lexer
+{
+    Scanner scanner;                    /**< @brief Underlying scanner */
+    TokenSpan window[LEXER_LOOKAHEAD];  /**< @brief Ring buffer of scanned token spans */
+    size_t first;                       /**< @brief Index of the next span in @c window */
+    size_t count;                       /**< @brief Number of spans in @c window */
+    Token token;                        /**< @brief Last token returned by @ref Lexer_peek or @ref Lexer_next */
+} Lexer;
+
+/**
+ * @brief Allocate a lexer that reads from some text
+ *
+ * @param text Input text (must outlive the lexer)
+ * @param length Length of the input text
+ * @param dialect Token rules to follow
+ * @returns Newly-created lexer
+ */
+Lexer* Lexer_new (const char* text, size_t length, LexDialect dialect);
+
+/**
+ * @brief Look ahead without consuming any tokens
+ *
+ * Throws an error if an invalid token is scanned. The returned span is owned
+ * by the lexer and is valid until the next call to @ref Lexer_next_span or
+ * @ref Lexer_next; its text is in the lexer's input.
+ *
+ * @param lexer Lexer to read from
+ * @param k Number of tokens to skip (must be less than #LEXER_LOOKAHEAD)
+ * @returns Span of the token @p k positions ahead (or @c NULL if the input
+ * ends first)
+ */
+const TokenSpan* Lexer_peek_span (Lexer* lexer, size_t k);
+
+/**
+ * @brief Consume the next token
+ *
+ * Throws an error if an invalid token is scanned.
+ *
+ * @param lexer Lexer to read from
+ * @param span Destination for the token's span
+ * @returns False at the end of the input
+ */
+bool Lexer_next_span (Lexer* lexer, TokenSpan* span);
+
+/**
+ * @brief Look ahead without consuming any tokens, copying out the token
+ *
+ * Same as @ref Lexer_peek_span, but the token's text is copied. The returned
+ * token is owned by the lexer and is valid until the next call to
+ * @ref Lexer_peek or @ref Lexer_next.
+ *
+ * @param lexer Lexer to read from
+ * @param k Number of tokens to skip (must be less than #LEXER_LOOKAHEAD)
+ * @returns Token @p k positions ahead (or @c NULL if the input ends first)
+ */
+Token* Lexer_peek (Lexer* lexer, size_t k);
+
+/**
+ * @brief Consume the next token, copying it out
+ *
+ * Same as @ref Lexer_next_span, but the token's text is copied. The returned
+ * token is owned by the lexer and is valid until the next call to
+ * @ref Lexer_peek or @ref Lexer_next.
+ *
+ * @param lexer Lexer to read from
+ * @returns Next token (or @c NULL at the end of the input)
+ */
+Token* Lexer_next (Lexer* lexer);
+
+/**
+ * @brief Deallocate a lexer
+ *
+ * @param lexer Lexer to deallocate
+ */
+void Lexer_free (Lexer* lexer);
+
+#endif
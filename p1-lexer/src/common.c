@@ -1,3 +1,11 @@
+/* mmap, read, and friends are POSIX rather than standard C */
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "common.h"
 
 const char* DecafType_to_string(DecafType type)
@@ -40,3 +48,171 @@ void print_doubly_escaped_string(const char* string, FILE* output)
     }
 }
 
+/**
+ * @brief Global string intern table (open addressing with linear probing)
+ */
+struct {
+    char** slots;       /**< @brief Interned strings (or @c NULL for empty slots) */
+    size_t capacity;    /**< @brief Number of slots (always a power of two) */
+    size_t count;       /**< @brief Number of interned strings */
+} intern_table = { NULL, 0, 0 };
+
+/**
+ * @brief FNV-1a hash of the first @p len characters of a string
+ */
+size_t hash_string (const char* string, size_t len)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (unsigned char)string[i];
+        hash *= 1099511628211ULL;
+    }
+    return (size_t)hash;
+}
+
+/**
+ * @brief Find the slot for a string (either its existing slot or the empty
+ * slot where it should be inserted)
+ */
+char** find_intern_slot (char** slots, size_t capacity, const char* string, size_t len)
+{
+    size_t i = hash_string(string, len) & (capacity - 1);
+    while (slots[i] != NULL &&
+           !(strncmp(slots[i], string, len) == 0 && slots[i][len] == '\0')) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &slots[i];
+}
+
+const char* intern_string_len (const char* string, size_t len)
+{
+    /* grow when the table would become more than half full */
+    if (2 * (intern_table.count + 1) > intern_table.capacity) {
+        size_t new_capacity = (intern_table.capacity == 0 ? 256 : intern_table.capacity * 2);
+        char** new_slots = (char**)calloc(new_capacity, sizeof(char*));
+        CHECK_MALLOC_PTR(new_slots);
+        for (size_t i = 0; i < intern_table.capacity; i++) {
+            char* old = intern_table.slots[i];
+            if (old != NULL) {
+                *find_intern_slot(new_slots, new_capacity, old, strlen(old)) = old;
+            }
+        }
+        free(intern_table.slots);
+        intern_table.slots = new_slots;
+        intern_table.capacity = new_capacity;
+    }
+
+    char** slot = find_intern_slot(intern_table.slots, intern_table.capacity, string, len);
+    if (*slot == NULL) {
+        *slot = (char*)calloc(len + 1, sizeof(char));
+        CHECK_MALLOC_PTR(*slot);
+        memcpy(*slot, string, len);
+        intern_table.count++;
+    }
+    return *slot;
+}
+
+const char* intern_string (const char* string)
+{
+    return intern_string_len(string, strlen(string));
+}
+
+const char* find_interned_string (const char* string)
+{
+    if (intern_table.capacity == 0) {
+        return NULL;
+    }
+    return *find_intern_slot(intern_table.slots, intern_table.capacity, string, strlen(string));
+}
+
+void free_interned_strings (void)
+{
+    for (size_t i = 0; i < intern_table.capacity; i++) {
+        free(intern_table.slots[i]);
+    }
+    free(intern_table.slots);
+    intern_table.slots = NULL;
+    intern_table.capacity = 0;
+    intern_table.count = 0;
+}
+
+/**
+ * @brief Read the rest of a file descriptor into a heap buffer
+ *
+ * @param fd File descriptor to read from
+ * @param size_hint Expected size (or zero if unknown)
+ * @param source Destination for the buffer and its length
+ * @returns True if and only if the read succeeded
+ */
+bool read_all (int fd, size_t size_hint, SourceText* source)
+{
+    size_t capacity = (size_hint > 0 ? size_hint + 1 : 65536);
+    size_t length = 0;
+    char* buffer = (char*)malloc(capacity);
+    CHECK_MALLOC_PTR(buffer);
+    while (true) {
+        if (length + 1 == capacity) {
+            capacity *= 2;
+            buffer = (char*)realloc(buffer, capacity);
+            CHECK_MALLOC_PTR(buffer);
+        }
+        ssize_t n = read(fd, buffer + length, capacity - length - 1);
+        if (n < 0) {
+            free(buffer);
+            return false;
+        } else if (n == 0) {
+            break;
+        }
+        length += (size_t)n;
+    }
+    buffer[length] = '\0';
+    source->text = buffer;
+    source->length = length;
+    source->mapped = false;
+    return true;
+}
+
+SourceText* SourceText_read (const char* filename)
+{
+    bool use_stdin = (strcmp(filename, "-") == 0);
+    int fd = (use_stdin ? STDIN_FILENO : open(filename, O_RDONLY));
+    if (fd < 0) {
+        return NULL;
+    }
+    SourceText* source = (SourceText*)calloc(1, sizeof(SourceText));
+    CHECK_MALLOC_PTR(source);
+
+    /* map regular files; the zero-filled tail of the last page supplies the
+     * NUL terminator, so files that end exactly on a page boundary are read */
+    struct stat info;
+    bool regular = (fstat(fd, &info) == 0 && S_ISREG(info.st_mode));
+    size_t size = (regular ? (size_t)info.st_size : 0);
+    if (size > 0 && size % (size_t)sysconf(_SC_PAGESIZE) != 0) {
+        void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            source->text = (const char*)map;
+            source->length = size;
+            source->mapped = true;
+        }
+    }
+
+    bool success = source->mapped || read_all(fd, size, source);
+    if (!use_stdin) {
+        close(fd);
+    }
+    if (!success) {
+        free(source);
+        return NULL;
+    }
+    return source;
+}
+
+void SourceText_free (SourceText* source)
+{
+    if (source->mapped) {
+        munmap((void*)source->text, source->length);
+    } else {
+        free((void*)source->text);
+    }
+    free(source);
+}
@@ -33,31 +33,6 @@ void Error_throw_printf (const char* format, ...)
     longjmp(decaf_error, 1);
 }
 
-/**
- * @brief Read all text data from a file
- *
- * @param filename Name of file to read
- * @param text String buffer destination (must be #MAX_FILE_SIZE characters long)
- * @returns True if and only if the file read was successful.
- */
-bool read_file (const char* filename, char* text)
-{
-    FILE* input = fopen(filename, "r");
-    if (input == NULL) {
-        return false;
-    }
-    size_t nchars = 0;
-    char* p = text;
-    int c;
-    while (nchars < MAX_FILE_SIZE && (c = fgetc(input)) != EOF) {
-        *p++ = (char)c;
-        nchars++;
-    }
-    *p = '\0';
-    fclose(input);
-    return true;
-}
-
 /**
  * @brief Compiler entry point
  *
@@ -68,16 +43,18 @@ bool read_file (const char* filename, char* text)
  */
 int main(int argc, char** argv)
 {
-    /* check for filename */
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <decaf-filename>\n", argv[0]);
+    /* check for options and filename */
+    bool use_regex = (argc == 3 && strcmp(argv[1], "--regex-lexer") == 0);
+    bool use_parallel = (argc == 3 && strcmp(argv[1], "--parallel-lexer") == 0);
+    if (argc != 2 && !use_regex && !use_parallel) {
+        fprintf(stderr, "Usage: %s [--regex-lexer|--parallel-lexer] <decaf-filename>\n", argv[0]);
         return EXIT_FAILURE;
     }
     char* filename = argv[argc-1];
 
     /* read file */
-    char text[MAX_FILE_SIZE];
-    if (!read_file(filename, text)) {
+    SourceText* source = SourceText_read(filename);
+    if (source == NULL) {
         fprintf(stderr, "Could not read file: %s", filename);
         exit(EXIT_FAILURE);
     }
@@ -85,27 +62,42 @@ int main(int argc, char** argv)
     /* FRONT END */
 
     TokenQueue* tokens = NULL;
+    Lexer* lexer = NULL;
 
     /* fatal errors are possible in the front end, so check for them */
     if (setjmp(decaf_error) == 0) {
 
         /* PROJECT 1: lexer */
-        tokens = lex(text);
+        if (use_regex || use_parallel) {
+            tokens = use_regex ? lex_regex(source->text)
+                               : lex_parallel(source->text, source->length, 0);
+            TokenQueue_print(tokens, stdout);
+        } else {
+            /* stream tokens as they are scanned (no queue needed) */
+            lexer = Lexer_new(source->text, source->length, LEX_PROJECT1);
+            for (Token* t = Lexer_next(lexer); t != NULL; t = Lexer_next(lexer)) {
+                Token_print(t, stdout);
+            }
+        }
 
     } else {
 
         /* handle fatal error: print message and clean up */
         fprintf(stderr, "%s", decaf_error_msg);
+        if (lexer != NULL) Lexer_free(lexer);
         if (tokens != NULL) TokenQueue_free(tokens);
+        SourceText_free(source);
+        lex_parallel_shutdown();
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
-    /* output */
-    TokenQueue_print(tokens, stdout);
-
     /* clean up */
-    TokenQueue_free(tokens);
-    tokens = NULL;
+    if (lexer != NULL) Lexer_free(lexer);
+    if (tokens != NULL) TokenQueue_free(tokens);
+    SourceText_free(source);
+    lex_parallel_shutdown();
+    free_interned_strings();
 
     return EXIT_SUCCESS;
 }
@@ -7,6 +7,30 @@
 #include "p1-lexer.h"
 
 TokenQueue* lex (const char* text)
+{
+    if (text == NULL) {
+        Error_throw_printf("No text");
+    }
+    return lex_text(text, strlen(text));
+}
+
+TokenQueue* lex_text (const char* text, size_t length)
+{
+    Scanner scanner;
+    Scanner_init(&scanner, text, length);
+    TokenQueue* tokens = TokenQueue_new();
+    TokenSpan span;
+    while (Scanner_try_next(&scanner, &span)) {
+        TokenQueue_add_span(tokens, text, &span);
+    }
+    if (scanner.error != LEX_OK) {
+        TokenQueue_free(tokens);
+        Scanner_throw_error(&scanner);
+    }
+    return tokens;
+}
+
+TokenQueue* lex_regex (const char* text)
 {
     if (text == NULL) {
         Error_throw_printf("No text");
@@ -23,7 +47,7 @@ TokenQueue* lex (const char* text)
     Regex* num = Regex_new("^(0|[1-9][0-9]*)");
     Regex* str_lit = Regex_new("^\"([^\"]*)\"");
     Regex* keyword = Regex_new("^(def|if|else|while|return|break|continue|int|bool|void|true|false)");
-    Regex* comment = Regex_new("^//.*");
+    Regex* comment = Regex_new("^//[^\n]*");
     // Adding reserved words as illegal
     Regex* reserved =
         Regex_new("^(for|callout|class|interface|extends|implements|new|this|string|float|double|null)");
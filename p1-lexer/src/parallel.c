@@ -0,0 +1,310 @@
+/**
+ * @file parallel.c
+ * @brief Multi-threaded lexing of large inputs (see @ref lex_parallel)
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "p1-lexer.h"
+#include "scan.h"
+
+/**
+ * @brief Tokens and final scanner state for one chunk of the input
+ */
+typedef struct LexChunk
+{
+    size_t start;           /**< @brief Offset of the first character in the chunk */
+    size_t end;             /**< @brief Offset just past the chunk (after a newline) */
+    Scanner scanner;        /**< @brief Scanner state after the chunk (lines are relative) */
+    bool ok;                /**< @brief False if the scanner stopped at an error */
+    TokenSpan* spans;       /**< @brief Tokens that start in the chunk */
+    size_t count;           /**< @brief Number of tokens in @c spans */
+    size_t capacity;        /**< @brief Allocated size of @c spans */
+} LexChunk;
+
+/**
+ * @brief Append a token to a chunk
+ */
+void LexChunk_add (LexChunk* chunk, const TokenSpan* span)
+{
+    if (chunk->count == chunk->capacity) {
+        chunk->capacity = (chunk->capacity == 0 ? 256 : chunk->capacity * 2);
+        chunk->spans = (TokenSpan*)realloc(chunk->spans, chunk->capacity * sizeof(TokenSpan));
+        CHECK_MALLOC_PTR(chunk->spans)
+    }
+    chunk->spans[chunk->count++] = *span;
+}
+
+/**
+ * @brief Scan all tokens that start before an offset
+ *
+ * The scanner is limited to the text before @p end so that the final run of
+ * blanks and comments does not spill into the next chunk. Only a string
+ * literal can cross the boundary (everything else stops at a newline); if one
+ * does, it is scanned again without the limit and the scanner stops after it.
+ *
+ * @param scanner Scanner positioned at or before @p end
+ * @param end Offset just past the range to scan
+ * @param chunk Destination for the tokens
+ * @returns False if the scanner stopped at an error
+ */
+bool scan_range (Scanner* scanner, size_t end, LexChunk* chunk)
+{
+    size_t length = scanner->length;
+    TokenSpan span;
+    while (scanner->pos < end) {
+        Scanner saved = *scanner;
+        scanner->length = end;
+        bool found = Scanner_try_next(scanner, &span);
+        scanner->length = length;
+        if (!found && scanner->error != LEX_OK) {
+            /* possibly a string literal that continues past the end */
+            *scanner = saved;
+            if (!Scanner_try_next(scanner, &span)) {
+                return false;
+            }
+        } else if (!found) {
+            break;
+        }
+        LexChunk_add(chunk, &span);
+    }
+    return true;
+}
+
+/**
+ * @brief Scan one chunk starting on (relative) line one
+ *
+ * @param chunk Chunk to scan
+ */
+void lex_chunk (LexChunk* chunk)
+{
+    chunk->scanner.pos = chunk->start;
+    chunk->scanner.line_start = chunk->start;
+    chunk->ok = scan_range(&chunk->scanner, chunk->end, chunk);
+}
+
+/**
+ * @brief Persistent worker threads shared by every call to @ref lex_parallel
+ *
+ * Workers are created the first time they are needed and then wait for the
+ * next batch of chunks instead of exiting, so repeated calls do not pay for
+ * thread creation. The calling thread scans chunks too, so a batch finishes
+ * even if fewer workers could be started than requested.
+ */
+typedef struct LexPool
+{
+    pthread_mutex_t call_lock;  /**< @brief Held for the duration of each call (one batch at a time) */
+    pthread_mutex_t lock;       /**< @brief Protects the remaining fields */
+    pthread_cond_t work_ready;  /**< @brief Signaled when a batch is posted (or on shutdown) */
+    pthread_cond_t work_done;   /**< @brief Signaled when the last chunk of a batch finishes */
+    pthread_t* threads;         /**< @brief Worker threads */
+    int num_threads;            /**< @brief Number of workers started */
+    LexChunk* chunks;           /**< @brief Current batch (or @c NULL) */
+    int num_chunks;             /**< @brief Number of chunks in the batch */
+    int next_chunk;             /**< @brief Index of the next chunk to claim */
+    int done_chunks;            /**< @brief Number of chunks finished */
+    bool shutdown;              /**< @brief Tells the workers to exit */
+} LexPool;
+
+/**
+ * @brief The worker pool (see @ref LexPool)
+ */
+LexPool lex_pool = {
+    .call_lock = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .work_ready = PTHREAD_COND_INITIALIZER,
+    .work_done = PTHREAD_COND_INITIALIZER,
+};
+
+/**
+ * @brief Claim and scan chunks of the current batch until none are left
+ *
+ * Must be called with the pool lock held; the lock is released while
+ * scanning.
+ */
+void LexPool_run_chunks (LexPool* pool)
+{
+    while (pool->next_chunk < pool->num_chunks) {
+        LexChunk* chunk = &pool->chunks[pool->next_chunk++];
+        pthread_mutex_unlock(&pool->lock);
+        lex_chunk(chunk);
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->done_chunks == pool->num_chunks) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+}
+
+/**
+ * @brief Worker thread entry point: scan chunks from each batch until shutdown
+ *
+ * @param arg Pool to work for (@c LexPool*)
+ */
+void* LexPool_worker (void* arg)
+{
+    LexPool* pool = (LexPool*)arg;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->shutdown) {
+        LexPool_run_chunks(pool);
+        pthread_cond_wait(&pool->work_ready, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/**
+ * @brief Start workers until the pool has the given number (or creation fails)
+ *
+ * Must be called with the call lock held.
+ */
+void LexPool_grow (LexPool* pool, int num_threads)
+{
+    if (num_threads <= pool->num_threads) {
+        return;
+    }
+    pthread_t* threads = (pthread_t*)realloc(pool->threads, num_threads * sizeof(pthread_t));
+    CHECK_MALLOC_PTR(threads)
+    pool->threads = threads;
+    while (pool->num_threads < num_threads &&
+           pthread_create(&pool->threads[pool->num_threads], NULL, LexPool_worker, pool) == 0) {
+        pool->num_threads++;
+    }
+}
+
+/**
+ * @brief Scan a batch of chunks with the pool and wait for all of them
+ *
+ * @param chunks Chunks to scan
+ * @param num_chunks Number of chunks (the pool grows to one worker fewer,
+ * since the calling thread scans too)
+ */
+void LexPool_scan (LexChunk* chunks, int num_chunks)
+{
+    LexPool* pool = &lex_pool;
+    pthread_mutex_lock(&pool->call_lock);
+    LexPool_grow(pool, num_chunks - 1);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->chunks = chunks;
+    pool->num_chunks = num_chunks;
+    pool->next_chunk = 0;
+    pool->done_chunks = 0;
+    pthread_cond_broadcast(&pool->work_ready);
+    LexPool_run_chunks(pool);
+    while (pool->done_chunks < pool->num_chunks) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pool->chunks = NULL;
+    pool->num_chunks = 0;
+    pool->next_chunk = 0;
+    pool->done_chunks = 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->call_lock);
+}
+
+void lex_parallel_shutdown (void)
+{
+    LexPool* pool = &lex_pool;
+    pthread_mutex_lock(&pool->call_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+    for (int i = 0; i < pool->num_threads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    free(pool->threads);
+    pool->threads = NULL;
+    pool->num_threads = 0;
+    pool->shutdown = false;
+    pthread_mutex_unlock(&pool->call_lock);
+}
+
+/**
+ * @brief Find the first chunk boundary (just after a newline) at or after an offset
+ */
+size_t next_line_start (const char* text, size_t length, size_t pos)
+{
+    if (pos == 0 || pos >= length) {
+        return (pos == 0 ? 0 : length);
+    }
+    const char* newline = (const char*)memchr(text + pos - 1, '\n', length - pos + 1);
+    return (newline == NULL ? length : (size_t)(newline - text) + 1);
+}
+
+TokenQueue* lex_parallel (const char* text, size_t length, int num_threads)
+{
+    if (text == NULL) {
+        Error_throw_printf("No text");
+    }
+    if (num_threads <= 0) {
+        num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (num_threads <= 1) {
+        return lex_text(text, length);
+    }
+
+    /* select the kernels now rather than racing to do it in the workers */
+    scan_init();
+
+    /* split at newlines and scan each chunk speculatively */
+    LexChunk* chunks = (LexChunk*)calloc(num_threads, sizeof(LexChunk));
+    CHECK_MALLOC_PTR(chunks)
+    size_t start = 0;
+    for (int i = 0; i < num_threads; i++) {
+        LexChunk* chunk = &chunks[i];
+        chunk->start = start;
+        chunk->end = (i == num_threads - 1 ? length :
+                next_line_start(text, length, length / num_threads * (i + 1)));
+        if (chunk->end < start) {
+            chunk->end = start;
+        }
+        start = chunk->end;
+        Scanner_init(&chunk->scanner, text, length);
+    }
+    LexPool_scan(chunks, num_threads);
+
+    /* stitch the chunks together in order */
+    TokenQueue* tokens = TokenQueue_new();
+    Scanner scanner;
+    Scanner_init(&scanner, text, length);
+    bool ok = true;
+    for (int i = 0; i < num_threads && ok; i++) {
+        LexChunk* chunk = &chunks[i];
+        if (scanner.pos == chunk->start) {
+            /* speculation was correct; shift line numbers by the preceding lines */
+            int offset = scanner.line - 1;
+            for (size_t j = 0; j < chunk->count; j++) {
+                chunk->spans[j].line += offset;
+                TokenQueue_add_span(tokens, text, &chunk->spans[j]);
+            }
+            ok = chunk->ok;
+            scanner.pos = chunk->scanner.pos;
+            scanner.line = chunk->scanner.line + offset;
+            scanner.line_start = chunk->scanner.line_start;
+            scanner.error = chunk->scanner.error;
+        } else if (scanner.pos < chunk->end) {
+            /* chunk began inside a string literal; scan it again serially */
+            chunk->count = 0;
+            ok = scan_range(&scanner, chunk->end, chunk);
+            for (size_t j = 0; j < chunk->count; j++) {
+                TokenQueue_add_span(tokens, text, &chunk->spans[j]);
+            }
+        }
+    }
+
+    /* clean up */
+    for (int i = 0; i < num_threads; i++) {
+        free(chunks[i].spans);
+    }
+    free(chunks);
+
+    if (!ok) {
+        TokenQueue_free(tokens);
+        Scanner_throw_error(&scanner);
+    }
+    return tokens;
+}
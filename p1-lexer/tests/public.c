@@ -70,6 +70,95 @@ TEST_1TOKEN(Lab_valid_hex_single_digit, "0x1", HEXLIT, "0x1")
 TEST_1TOKEN(Lab_another_valid_hex_single_digit, "0x2", HEXLIT, "0x2")
 TEST_1TOKEN(Lab_another_valid_hex_single_digit2, "0x3", HEXLIT, "0x3")
 
+TEST_2TOKENS(B_comment_ends_at_newline, "x // c\ny", ID, "x", ID, "y")
+TEST_SPAN(B_span_first, "foo = 0x1f;", 0, "foo", 1, 1)
+TEST_SPAN(B_span_hex, "foo = 0x1f;", 2, "0x1f", 1, 7)
+TEST_SPAN(B_span_next_line, "a\n  \t bb // c\n", 1, "bb", 2, 5)
+TEST_SPAN(B_span_truncated_input, "ab==", 1, "==", 1, 3)
+TEST_LOOKAHEAD(B_lookahead_next, "a b c d", 0, "b")
+TEST_LOOKAHEAD(B_lookahead_far, "a b c d", 2, "d")
+TEST_SAME_AS_STREAM(B_stream_program, "def int main() {\n  int x;\n  x = 0x1F + 007;\n  return x;\n}\n", 0)
+TEST_SAME_AS_STREAM(B_stream_lookahead, "def int main() {\n  int x;\n  x = 0x1F + 007;\n  return x;\n}\n", LEXER_LOOKAHEAD - 1)
+TEST_SAME_AS_STREAM(B_stream_empty, "  // nothing here\n", 1)
+TEST_SAME_AS_STREAM(B_stream_invalid, "a b c ~ d", 2)
+TEST_SAME_AS_PARALLEL(B_parallel_program, "def int main() {\n  int x;\n  x = 0x1F + 007;\n\n  // done\n  return x;\n}\n", 4)
+TEST_SAME_AS_PARALLEL(B_parallel_string_across_chunks, "a\n\"b\nc\nd\ne\nf\" g\nh\ni\n", 5)
+TEST_SAME_AS_PARALLEL(B_parallel_more_threads_than_lines, "x\ny", 8)
+TEST_SAME_AS_PARALLEL(B_parallel_error_line, "a\nb\nc\nd ~\ne\nf\ng ~\n", 3)
+TEST_SAME_AS_PARALLEL(B_parallel_error_after_string, "\"a\nb\nc\" d\ne\nf\nnew\n", 3)
+TEST_SAME_AS_PARALLEL(B_parallel_unterminated_string, "a\nb\n\"c\nd\ne\n", 3)
+
+START_TEST (B_parallel_pool_reuse)
+{
+    /* the worker pool persists across calls, grows, and restarts after shutdown */
+    char* text = "def int main() {\n  int x;\n  x = \"a\nb\";\n  return x;\n}\n";
+    for (int i = 0; i < 20; i++) {
+        ck_assert (same_as_parallel(text, 2 + i % 5));
+        ck_assert (same_as_parallel("a\nb\nc\nd ~\ne\n", 3));
+    }
+    lex_parallel_shutdown();
+    ck_assert (same_as_parallel(text, 4));
+    lex_parallel_shutdown();
+}
+END_TEST
+TEST_SAME_AS_SCALAR(B_simd_blank_lines, "a\n\n  \t\n                                        \n\n\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\tb\n c")
+TEST_SAME_AS_SCALAR(B_simd_long_comment, "x // this comment is much longer than thirty-two bytes, so it spans several blocks\ny")
+TEST_SAME_AS_SCALAR(B_simd_long_string, "\"a string literal that is long enough to need more than one SIMD block\" z")
+TEST_SAME_AS_SCALAR(B_simd_unterminated_string, "\"a string literal that is long enough to need more than one SIMD block")
+TEST_SAME_AS_SCALAR(B_simd_trailing_blanks, "q                                                                 ")
+TEST_SAME_AS_REGEX(B_dfa_program, "def int main() {\n  int x;\n  x = 0x1F + 007;\n  return x;\n}\n")
+TEST_SAME_AS_REGEX(B_dfa_symbols, "a<=b!=c>=d==e=f;g[0](h){}-%*+\\")
+TEST_SAME_AS_REGEX(B_dfa_comment_lines, "x // comment\ny // another\n\tz")
+TEST_SAME_AS_REGEX(B_dfa_multiline_string, "\"a\nb\" c")
+TEST_SAME_AS_REGEX(B_dfa_hex_prefix_only, "0x 0xg 00")
+TEST_SAME_AS_REGEX(B_dfa_keywords, "if else while return break continue int bool void true false ifx int_")
+TEST_SAME_AS_REGEX(B_dfa_reserved, "x = new")
+TEST_SAME_AS_REGEX(B_dfa_unterminated_string, "\"abc")
+TEST_SAME_AS_REGEX(B_dfa_lone_less_than, "a < b")
+TEST_SAME_AS_REGEX(B_dfa_single_slash, "a / b")
+
+START_TEST (B_regex_match_lines)
+{
+    /* single-line expressions only search the current line, with the same result */
+    char match[MAX_TOKEN_LEN];
+    Regex* num = Regex_new("^0|^[1-9][0-9]*");
+    ck_assert (Regex_match(num, "12 x\ny 34", match));
+    ck_assert_str_eq (match, "12");
+    ck_assert (!Regex_match(num, "x\n5", match));
+    Regex* word = Regex_new("^ab$");
+    ck_assert (!Regex_match(word, "ab\ncd", match));
+    ck_assert (Regex_match(word, "ab", match));
+    Regex* str = Regex_new("^\"[^\"]*\"");
+    ck_assert (Regex_match(str, "\"a\nb\" c", match));
+    ck_assert_str_eq (match, "\"a\nb\"");
+    Regex_free(num);
+    Regex_free(word);
+    Regex_free(str);
+}
+END_TEST
+
+START_TEST (B_token_new_blocks)
+{
+    /* tokens share blocks, and a block lasts until all of its tokens are freed */
+    Token* tokens[TOKEN_BLOCK_SIZE + 1];
+    for (int i = 0; i <= TOKEN_BLOCK_SIZE; i++) {
+        tokens[i] = Token_new(DECLIT, "42", i);
+    }
+    TokenBlock* first = tokens[0]->block;
+    ck_assert (tokens[TOKEN_BLOCK_SIZE - 1]->block == first);
+    ck_assert (tokens[TOKEN_BLOCK_SIZE]->block != first);
+    ck_assert_int_eq (first->live, TOKEN_BLOCK_SIZE);
+    for (int i = 0; i < TOKEN_BLOCK_SIZE - 1; i++) {
+        Token_free(tokens[i]);
+    }
+    ck_assert_int_eq (first->live, 1);
+    ck_assert_str_eq (tokens[TOKEN_BLOCK_SIZE - 1]->text, "42");
+    ck_assert_int_eq (tokens[TOKEN_BLOCK_SIZE - 1]->line, TOKEN_BLOCK_SIZE - 1);
+    Token_free(tokens[TOKEN_BLOCK_SIZE - 1]);
+    Token_free(tokens[TOKEN_BLOCK_SIZE]);
+}
+END_TEST
+
 #endif
 
 /**
@@ -127,6 +216,41 @@ void public_tests (Suite *s)
     TEST(Lab_valid_hex_single_digit);
     TEST(Lab_another_valid_hex_single_digit);
     TEST(Lab_another_valid_hex_single_digit2);
+    TEST(B_span_first);
+    TEST(B_span_hex);
+    TEST(B_span_next_line);
+    TEST(B_span_truncated_input);
+    TEST(B_lookahead_next);
+    TEST(B_lookahead_far);
+    TEST(B_stream_program);
+    TEST(B_stream_lookahead);
+    TEST(B_stream_empty);
+    TEST(B_stream_invalid);
+    TEST(B_parallel_program);
+    TEST(B_parallel_string_across_chunks);
+    TEST(B_parallel_more_threads_than_lines);
+    TEST(B_parallel_error_line);
+    TEST(B_parallel_error_after_string);
+    TEST(B_parallel_unterminated_string);
+    TEST(B_parallel_pool_reuse);
+    TEST(B_simd_blank_lines);
+    TEST(B_simd_long_comment);
+    TEST(B_simd_long_string);
+    TEST(B_simd_unterminated_string);
+    TEST(B_simd_trailing_blanks);
+    TEST(B_comment_ends_at_newline);
+    TEST(B_dfa_program);
+    TEST(B_dfa_symbols);
+    TEST(B_dfa_comment_lines);
+    TEST(B_dfa_multiline_string);
+    TEST(B_regex_match_lines);
+    TEST(B_token_new_blocks);
+    TEST(B_dfa_hex_prefix_only);
+    TEST(B_dfa_keywords);
+    TEST(B_dfa_reserved);
+    TEST(B_dfa_unterminated_string);
+    TEST(B_dfa_lone_less_than);
+    TEST(B_dfa_single_slash);
 
 
     suite_add_tcase (s, tc);
@@ -1,9 +1,14 @@
 #include "testsuite.h"
 
 jmp_buf decaf_error;
+char decaf_error_msg[MAX_ERROR_LEN];
 
 void Error_throw_printf (const char* format, ...)
 {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(decaf_error_msg, MAX_ERROR_LEN, format, args);
+    va_end(args);
     longjmp(decaf_error, 1);
 }
 
@@ -96,6 +101,155 @@ bool valid_tokens(char* text, size_t ntokens, Token expected_tokens[])
     return true;
 }
 
+TokenQueue* run_regex_lexer (char* text)
+{
+    if (setjmp(decaf_error) == 0) {
+        /* no error */
+        return lex_regex(text);
+    } else {
+        /* error; return NULL */
+        return NULL;
+    }
+}
+
+bool same_as_regex (char* text)
+{
+    TokenQueue* tokens = run_lexer(text);
+    TokenQueue* expected = run_regex_lexer(text);
+    if (tokens == NULL || expected == NULL) {
+        /* both lexers must report an error */
+        bool same = (tokens == NULL && expected == NULL);
+        if (tokens != NULL)   { TokenQueue_free(tokens); }
+        if (expected != NULL) { TokenQueue_free(expected); }
+        return same;
+    }
+    return same_tokens(tokens, expected);
+}
+
+bool same_tokens (TokenQueue* tokens, TokenQueue* expected)
+{
+    bool same = (TokenQueue_size(tokens) == TokenQueue_size(expected));
+    for (Token *t = tokens->head, *e = expected->head; same && t != NULL; t = t->next, e = e->next) {
+        same = (t->type == e->type && t->line == e->line &&
+                strncmp(t->text, e->text, MAX_TOKEN_LEN) == 0);
+    }
+    TokenQueue_free(tokens);
+    TokenQueue_free(expected);
+    return same;
+}
+
+bool same_as_scalar (char* text)
+{
+    scan_select(SCAN_SCALAR);
+    TokenQueue* expected = run_lexer(text);
+    scan_select(SCAN_AUTO);
+    TokenQueue* tokens = run_lexer(text);
+    if (tokens == NULL || expected == NULL) {
+        /* both kernels must report an error */
+        bool same = (tokens == NULL && expected == NULL);
+        if (tokens != NULL)   { TokenQueue_free(tokens); }
+        if (expected != NULL) { TokenQueue_free(expected); }
+        return same;
+    }
+    return same_tokens(tokens, expected);
+}
+
+bool same_as_parallel (char* text, int num_threads)
+{
+    char expected_error[MAX_ERROR_LEN] = "";
+    TokenQueue* expected = run_lexer(text);
+    if (expected == NULL) {
+        snprintf(expected_error, MAX_ERROR_LEN, "%s", decaf_error_msg);
+    }
+    if (setjmp(decaf_error) != 0) {
+        /* the serial lexer must report the same error */
+        return expected == NULL && strncmp(decaf_error_msg, expected_error, MAX_ERROR_LEN) == 0;
+    }
+    TokenQueue* tokens = lex_parallel(text, strlen(text), num_threads);
+    if (expected == NULL) {
+        TokenQueue_free(tokens);
+        return false;
+    }
+    return same_tokens(tokens, expected);
+}
+
+bool valid_span (char* text, size_t index, const char* expected_text, int line, int column)
+{
+    Scanner scanner;
+    TokenSpan span;
+    if (setjmp(decaf_error) != 0) {
+        /* lexing error */
+        return false;
+    }
+    Scanner_init(&scanner, text, strlen(text));
+    for (size_t i = 0; i <= index; i++) {
+        if (!Scanner_next(&scanner, &span)) {
+            /* not enough tokens */
+            return false;
+        }
+    }
+    return TokenSpan_text_eq(text, &span, expected_text) &&
+           span.line == line && span.column == column;
+}
+
+bool valid_lookahead (char* text, size_t k, const char* expected_text)
+{
+    TokenQueue* tokens = run_lexer(text);
+    if (tokens == NULL || TokenQueue_is_empty(tokens))
+        { return false; }
+    size_t size = TokenQueue_size(tokens);
+    Token_free(TokenQueue_remove(tokens));          /* consume first token */
+    Token* token = TokenQueue_peek_ahead(tokens, k);
+    bool valid = (TokenQueue_size(tokens) == size - 1) && (token != NULL) &&
+                 (strncmp(token->text, expected_text, MAX_TOKEN_LEN) == 0) &&
+                 (TokenQueue_peek_ahead(tokens, size - 1) == NULL);
+    TokenQueue_free(tokens);
+    return valid;
+}
+
+bool same_as_stream (char* text, size_t k)
+{
+    TokenQueue* expected = run_lexer(text);
+    Lexer* lexer = Lexer_new(text, strlen(text), LEX_PROJECT1);
+    bool valid = true;
+    if (setjmp(decaf_error) != 0) {
+        /* lexing error: valid only if the queue-based lexer also failed */
+        Lexer_free(lexer);
+        if (expected == NULL) {
+            return true;
+        }
+        TokenQueue_free(expected);
+        return false;
+    }
+    if (expected == NULL) {
+        /* the streaming lexer must also fail */
+        while (Lexer_next(lexer) != NULL) { }
+        Lexer_free(lexer);
+        return false;
+    }
+    while (valid) {
+        /* every token must be visible k positions ahead before it is consumed */
+        Token* ahead = Lexer_peek(lexer, k);
+        Token* want_ahead = TokenQueue_peek_ahead(expected, k);
+        valid = (ahead == NULL) == (want_ahead == NULL) &&
+                (ahead == NULL || strncmp(ahead->text, want_ahead->text, MAX_TOKEN_LEN) == 0);
+        Token* token = Lexer_next(lexer);
+        if (token == NULL) {
+            valid = valid && TokenQueue_is_empty(expected);
+            break;
+        }
+        Token* want = (TokenQueue_is_empty(expected) ? NULL : TokenQueue_remove(expected));
+        valid = valid && want != NULL && token->type == want->type && token->line == want->line &&
+                strncmp(token->text, want->text, MAX_TOKEN_LEN) == 0;
+        if (want != NULL) {
+            Token_free(want);
+        }
+    }
+    Lexer_free(lexer);
+    TokenQueue_free(expected);
+    return valid;
+}
+
 extern void public_tests (Suite *s);
 extern void private_tests (Suite *s);
 
@@ -13,6 +13,7 @@
 #include <check.h>
 
 #include "p1-lexer.h"
+#include "scan.h"
 
 /**
  * @brief Define a test case with text containing an invalid token
@@ -49,6 +50,50 @@ END_TEST
 { ck_assert (valid_tokens(TEXT, NTOKENS, ETOKENS)); } \
 END_TEST
 
+/**
+ * @brief Define a test that checks the scanner against the regex lexer
+ */
+#define TEST_SAME_AS_REGEX(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_as_regex(TEXT)); } \
+END_TEST
+
+/**
+ * @brief Define a test that checks the text and position of a token span
+ */
+#define TEST_SPAN(NAME,TEXT,INDEX,ETEXT,LINE,COLUMN) START_TEST (NAME) \
+{ ck_assert (valid_span(TEXT, INDEX, ETEXT, LINE, COLUMN)); } \
+END_TEST
+
+/**
+ * @brief Define a test that checks lookahead after consuming the first token
+ */
+#define TEST_LOOKAHEAD(NAME,TEXT,K,ETEXT) START_TEST (NAME) \
+{ ck_assert (valid_lookahead(TEXT, K, ETEXT)); } \
+END_TEST
+
+/**
+ * @brief Define a test that checks the streaming lexer against the queue-based
+ * one
+ */
+#define TEST_SAME_AS_STREAM(NAME,TEXT,K) START_TEST (NAME) \
+{ ck_assert (same_as_stream(TEXT, K)); } \
+END_TEST
+
+/**
+ * @brief Define a test that checks the parallel lexer against the serial one
+ */
+#define TEST_SAME_AS_PARALLEL(NAME,TEXT,THREADS) START_TEST (NAME) \
+{ ck_assert (same_as_parallel(TEXT, THREADS)); } \
+END_TEST
+
+/**
+ * @brief Define a test that checks the SIMD scanning kernels against the
+ * scalar ones
+ */
+#define TEST_SAME_AS_SCALAR(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_as_scalar(TEXT)); } \
+END_TEST
+
 /**
  * @brief Add a test to the test suite
  */
@@ -133,3 +178,86 @@ bool valid_2tokens (char* text, TokenType expected_type1, const char* expected_t
  * expected types
  */
 bool valid_tokens(char* text, size_t ntokens, Token expected_tokens[]);
+
+/**
+ * @brief Run the regex lexer on given text (catching exceptions like run_lexer())
+ *
+ * @param text Code to lex
+ * @returns Queue of tokens or @c NULL if there was a lexing error
+ */
+TokenQueue* run_regex_lexer (char* text);
+
+/**
+ * @brief Run both lexers on given text and verify that they agree
+ *
+ * @param text Code to lex
+ * @returns True if and only if both lexers threw an exception or both produced
+ * the same tokens (type, text, and line)
+ */
+bool same_as_regex (char* text);
+
+/**
+ * @brief Scan given text and verify the text and position of one token span
+ *
+ * @param text Code to scan
+ * @param index Index of the token to check (0-based)
+ * @param expected_text Expected text of the token
+ * @param line Expected line number
+ * @param column Expected column number
+ * @returns True if and only if the text was scanned successfully and the token
+ * has the expected text and position
+ */
+bool valid_span (char* text, size_t index, const char* expected_text, int line, int column);
+
+/**
+ * @brief Lex given text, consume the first token, and verify the queue's size
+ * and lookahead
+ *
+ * @param text Code to lex
+ * @param k Lookahead distance after consuming the first token
+ * @param expected_text Expected text of the token @p k positions ahead
+ * @returns True if and only if the size and lookahead are correct
+ */
+bool valid_lookahead (char* text, size_t k, const char* expected_text);
+
+/**
+ * @brief Lex given text with the streaming lexer and with the queue-based one,
+ * and verify that the results agree
+ *
+ * @param text Code to lex
+ * @param k Lookahead distance to check before consuming each token
+ * @returns True if and only if both lexers threw an exception or both produced
+ * the same tokens
+ */
+bool same_as_stream (char* text, size_t k);
+
+/**
+ * @brief Lex given text with the parallel lexer and with the serial one, and
+ * verify that the results agree
+ *
+ * @param text Code to lex
+ * @param num_threads Number of threads (and chunks) for the parallel lexer
+ * @returns True if and only if both lexers threw the same error or both
+ * produced the same tokens
+ */
+bool same_as_parallel (char* text, int num_threads);
+
+/**
+ * @brief Compare two token queues and deallocate both of them
+ *
+ * @param tokens Actual tokens
+ * @param expected Expected tokens
+ * @returns True if and only if the queues have the same tokens (type, text,
+ * and line)
+ */
+bool same_tokens (TokenQueue* tokens, TokenQueue* expected);
+
+/**
+ * @brief Lex given text with the scalar scanning kernels and with the fastest
+ * kernels supported by the CPU, and verify that the results agree
+ *
+ * @param text Code to lex
+ * @returns True if and only if both runs threw an exception or both produced
+ * the same tokens
+ */
+bool same_as_scalar (char* text);
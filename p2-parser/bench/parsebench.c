@@ -0,0 +1,278 @@
+/**
+ * @file parsebench.c
+ * @brief Expression parser benchmark on generated expression-heavy programs
+ *
+ * Generates a Decaf program whose functions assign long random expressions
+ * (every binary operator, unary operators, parentheses, calls, and array
+ * accesses), lexes it once, and times @ref parse with each expression
+ * parser (see @ref parse_select_expr). The best time of each is reported
+ * along with the speedup. The printed trees are also compared to make sure
+ * both parsers agree.
+ *
+ * The default program is small (64KB) because the precompiled lexer slows
+ * down sharply on large inputs; use -s to change it.
+ *
+ * Run with "make bench".
+ */
+#include <time.h>
+
+#include "p1-lexer.h"
+#include "p2-parser.h"
+
+/**
+ * @brief Error message buffer
+ */
+char decaf_error_msg[MAX_ERROR_LEN];
+
+/**
+ * @brief Data structure used by @c setjmp / @c longjmp for exception handling
+ */
+jmp_buf decaf_error;
+
+void Error_throw_printf (const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vsnprintf(decaf_error_msg, MAX_ERROR_LEN, format, args);
+    va_end(args);
+    longjmp(decaf_error, 1);
+}
+
+/**
+ * @brief Binary operators used in generated expressions
+ */
+const char* operators[] = {
+    "||", "&&", "==", "!=", "<", "<=", ">=", ">", "+", "-", "*", "/", "%"
+};
+
+/**
+ * @brief Simple growable output buffer
+ */
+typedef struct Buffer
+{
+    char* text;         /**< @brief Contents (NUL-terminated) */
+    size_t length;      /**< @brief Number of characters used */
+    size_t capacity;    /**< @brief Allocated size */
+} Buffer;
+
+/**
+ * @brief Append a string to a buffer
+ */
+void Buffer_add (Buffer* buffer, const char* text)
+{
+    size_t len = strlen(text);
+    if (buffer->length + len + 1 > buffer->capacity) {
+        buffer->capacity = (buffer->capacity + len + 1) * 2;
+        buffer->text = (char*)realloc(buffer->text, buffer->capacity);
+        CHECK_MALLOC_PTR(buffer->text)
+    }
+    memcpy(buffer->text + buffer->length, text, len + 1);
+    buffer->length += len;
+}
+
+/**
+ * @brief Append a random expression with the given number of operators
+ */
+void gen_expr (Buffer* buffer, int size, int depth)
+{
+    if (size == 0 || depth > 8) {
+        /* primary expression */
+        char primary[32];
+        switch (rand() % 6) {
+            case 0:  snprintf(primary, sizeof(primary), "%d", rand() % 1000); break;
+            case 1:  snprintf(primary, sizeof(primary), "0x%x", rand() % 4096); break;
+            case 2:  snprintf(primary, sizeof(primary), "g[%d]", rand() % 10); break;
+            case 3:  snprintf(primary, sizeof(primary), "-%c", 'a' + rand() % 3); break;
+            default: snprintf(primary, sizeof(primary), "%c", 'a' + rand() % 3); break;
+        }
+        Buffer_add(buffer, primary);
+        return;
+    }
+    int left = rand() % size;
+    switch (rand() % 8) {
+        case 0:
+            Buffer_add(buffer, "(");
+            gen_expr(buffer, size, depth + 1);
+            Buffer_add(buffer, ")");
+            break;
+        case 1:
+            Buffer_add(buffer, "f(");
+            gen_expr(buffer, left, depth + 1);
+            Buffer_add(buffer, ", ");
+            gen_expr(buffer, size - left - 1, depth + 1);
+            Buffer_add(buffer, ")");
+            break;
+        default:
+            gen_expr(buffer, left, depth + 1);
+            Buffer_add(buffer, " ");
+            Buffer_add(buffer, operators[rand() % (sizeof(operators) / sizeof(operators[0]))]);
+            Buffer_add(buffer, " ");
+            gen_expr(buffer, size - left - 1, depth + 1);
+            break;
+    }
+}
+
+/**
+ * @brief Generate a program of approximately the given size
+ *
+ * @returns Generated text (caller must free)
+ */
+char* generate (size_t size, int ops_per_expr)
+{
+    Buffer buffer = { NULL, 0, 0 };
+    Buffer_add(&buffer, "int g[10];\ndef int f(int a, int b) { return a; }\n");
+    for (int i = 0; buffer.length < size; i++) {
+        char header[64];
+        snprintf(header, sizeof(header), "def int f%d(int a, int b, int c) {\n", i);
+        Buffer_add(&buffer, header);
+        for (int j = 0; j < 5; j++) {
+            Buffer_add(&buffer, "    a = ");
+            gen_expr(&buffer, ops_per_expr, 0);
+            Buffer_add(&buffer, ";\n");
+        }
+        Buffer_add(&buffer, "    return a;\n}\n");
+    }
+    return buffer.text;
+}
+
+/**
+ * @brief Get the current wall clock time in seconds
+ */
+double wall_time (void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Make a copy of a token queue (the parser consumes its input)
+ */
+TokenQueue* copy_tokens (TokenQueue* tokens)
+{
+    TokenQueue* copy = TokenQueue_new();
+    for (Token* t = tokens->head; t != NULL; t = t->next) {
+        TokenQueue_add(copy, Token_new(t->type, t->text, t->line));
+    }
+    return copy;
+}
+
+/**
+ * @brief Parse a token queue repeatedly with one expression parser
+ *
+ * @param tokens Program tokens (not modified)
+ * @param impl Expression parser
+ * @param reps Number of runs
+ * @param tree Set to the tree from the last run (caller must free)
+ * @returns Best parse time in seconds (copying the tokens is not timed)
+ */
+double time_parse (TokenQueue* all_tokens, ExprParser impl, int reps, ASTNode** tree)
+{
+    parse_select_expr(impl);
+    double best = -1.0;
+    *tree = NULL;
+    for (int r = 0; r < reps; r++) {
+        if (*tree != NULL) {
+            ASTNode_free(*tree);
+        }
+        TokenQueue* tokens = copy_tokens(all_tokens);
+        double start = wall_time();
+        *tree = parse(tokens);
+        double elapsed = wall_time() - start;
+        TokenQueue_free(tokens);
+        if (best < 0.0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Print a tree to a temporary file (for comparison)
+ */
+FILE* print_tree (ASTNode* tree)
+{
+    FILE* out = tmpfile();
+    if (out != NULL) {
+        NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
+        NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+        NodeVisitor_traverse_and_free(PrintVisitor_new(out), tree);
+        rewind(out);
+    }
+    return out;
+}
+
+/**
+ * @brief Compare the contents of two files
+ */
+bool same_contents (FILE* a, FILE* b)
+{
+    int c;
+    while ((c = fgetc(a)) == fgetc(b)) {
+        if (c == EOF) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main (int argc, char** argv)
+{
+    size_t size = 64 << 10;
+    int ops = 30;
+    int reps = 5;
+    bool generate_only = false;
+    for (int i = 1; i < argc; i++) {
+        bool has_arg = (i + 1 < argc);
+        if (strcmp(argv[i], "-s") == 0 && has_arg) {
+            size = strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "-o") == 0 && has_arg) {
+            ops = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && has_arg) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--generate") == 0) {
+            generate_only = true;
+        } else {
+            fprintf(stderr, "Usage: %s [-s <bytes>] [-o <operators-per-expression>] [-r <repetitions>]\n"
+                            "       [--generate]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    srand(432);
+    char* text = generate(size, ops);
+    if (setjmp(decaf_error) != 0) {
+        fprintf(stderr, "%s", decaf_error_msg);
+        return EXIT_FAILURE;
+    }
+
+    if (generate_only) {
+        fputs(text, stdout);
+        free(text);
+        return EXIT_SUCCESS;
+    }
+    TokenQueue* tokens = lex(text);
+
+    ASTNode* descent_tree;
+    ASTNode* climbing_tree;
+    double descent = time_parse(tokens, EXPR_DESCENT, reps, &descent_tree);
+    double climbing = time_parse(tokens, EXPR_PRECEDENCE, reps, &climbing_tree);
+
+    FILE* descent_out = print_tree(descent_tree);
+    FILE* climbing_out = print_tree(climbing_tree);
+    bool same = descent_out != NULL && climbing_out != NULL &&
+                same_contents(descent_out, climbing_out);
+
+    printf("program: %zu bytes, %d operators per expression\n", strlen(text), ops);
+    printf("%-20s %10.2f ms\n", "recursive descent", descent * 1000.0);
+    printf("%-20s %10.2f ms\n", "precedence climbing", climbing * 1000.0);
+    printf("speedup: %.2fx, trees %s\n", descent / climbing, (same ? "identical" : "DIFFER"));
+
+    if (descent_out != NULL) fclose(descent_out);
+    if (climbing_out != NULL) fclose(climbing_out);
+    ASTNode_free(descent_tree);
+    ASTNode_free(climbing_tree);
+    TokenQueue_free(tokens);
+    free(text);
+    return (same ? EXIT_SUCCESS : EXIT_FAILURE);
+}
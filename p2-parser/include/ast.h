@@ -22,6 +22,38 @@ typedef void (*AttributeValueDOTPrinter)(void*, FILE*);
  */
 typedef void (*Destructor)(void*);
 
+/**
+ * @brief Storage for names (of variables, functions, and parameters) in AST
+ * structures
+ *
+ * By default, names and string literal values are stored inline in fixed-size
+ * arrays, so every node is sized for the longest name. The precompiled objects
+ * used in Projects 3-5 were compiled against this layout and access the arrays
+ * directly, so it must be kept there.
+ *
+ * If @c DECAF_COMPACT_AST is defined (see make.config), names are interned
+ * (see @ref intern_string) and string literal values are allocated separately
+ * (see @ref ASTString), which shrinks nodes from 352 to 104 bytes. Both are
+ * read the same way (e.g., @c node->vardecl.name).
+ */
+#ifdef DECAF_COMPACT_AST
+typedef const char* ASTName;
+#else
+typedef char ASTName[MAX_ID_LEN];
+#endif
+
+/**
+ * @brief Storage for string literal values in AST nodes (see @ref ASTName)
+ *
+ * In the compact layout, values are allocated with @ref ast_calloc and are
+ * deallocated along with the node.
+ */
+#ifdef DECAF_COMPACT_AST
+typedef char* ASTString;
+#else
+typedef char ASTString[MAX_LINE_LEN];
+#endif
+
 /**
  * @brief Fake "free" function that does nothing
  *
@@ -89,7 +121,7 @@ struct ASTNode* ProgramNode_new (struct NodeList* vars, struct NodeList* funcs);
  * @brief AST variable structure
  */
 typedef struct VarDeclNode {
-    char name[MAX_ID_LEN];      /**< @brief Variable name */
+    ASTName name;               /**< @brief Variable name */
     DecafType type;             /**< @brief Variable type */
     bool is_array;              /**< @brief True if the variable is an array, false if it's a scalar */
     int array_length;           /**< @brief Length of array (should be 1 if not an array) */
@@ -112,7 +144,7 @@ struct ASTNode* VarDeclNode_new (const char* name, DecafType type,
  * @brief AST parameter (used in function declarations)
  */
 typedef struct Parameter {
-    char name[MAX_ID_LEN];      /**< @brief Parameter formal name */
+    ASTName name;               /**< @brief Parameter formal name */
     DecafType type;             /**< @brief Parameter type */
     struct Parameter* next;     /**< @brief Pointer to next parameter (if in a list) */
 } Parameter;
@@ -136,7 +168,7 @@ void ParameterList_add_new (ParameterList* list, const char* name, DecafType typ
  * @brief AST function structure
  */
 typedef struct FuncDeclNode {
-    char name[MAX_ID_LEN];      /**< @brief Function name */
+    ASTName name;               /**< @brief Function name */
     DecafType return_type;      /**< @brief Function return type */
     ParameterList* parameters;  /**< @brief List of formal parameters */
     struct ASTNode* body;       /**< @brief Function body block */
@@ -345,7 +377,7 @@ struct ASTNode* UnaryOpNode_new (UnaryOpType operator, struct ASTNode* child, in
  * @c index can be @c NULL for non-array locations.
  */
 typedef struct LocationNode {
-    char name[MAX_ID_LEN];      /**< @brief Location/variable name */
+    ASTName name;               /**< @brief Location/variable name */
     struct ASTNode* index;      /**< @brief Index expression (can be @c NULL for non-array locations) */
 } LocationNode;
 
@@ -363,7 +395,7 @@ struct ASTNode* LocationNode_new (const char* name, struct ASTNode* index, int s
  * @brief AST function call expression structure
  */
 typedef struct FuncCallNode {
-    char name[MAX_ID_LEN];      /**< @brief Function name */
+    ASTName name;               /**< @brief Function name */
     struct NodeList* arguments; /**< @brief List of actual parameters/arguments */
 } FuncCallNode;
 
@@ -385,7 +417,7 @@ typedef struct LiteralNode {
     union {
         int integer;                /**< @brief Integer value (if @c type is @c INT) */
         bool boolean;               /**< @brief Boolean value (if @c type is @c BOOL) */
-        char string[MAX_LINE_LEN];  /**< @brief String value (if @c type is @c STR) */
+        ASTString string;           /**< @brief String value (if @c type is @c STR) */
     };
 } LiteralNode;
 
@@ -416,6 +448,35 @@ struct ASTNode* LiteralNode_new_bool (bool value, int source_line);
  */
 struct ASTNode* LiteralNode_new_string (const char* value, int source_line);
 
+/**
+ * @brief Well-known attributes that have a dedicated slot in every node
+ *
+ * These are accessed constantly by the analysis and code generation phases,
+ * so each node keeps a direct pointer to them (see @ref ASTNode_get_slot).
+ * Other attributes are only stored in the attribute list.
+ */
+typedef enum AttributeSlot {
+    SLOT_PARENT, SLOT_DEPTH, SLOT_SYMBOL_TABLE, SLOT_TYPE, SLOT_CODE, SLOT_REG,
+    NUM_ATTRIBUTE_SLOTS,
+    NO_SLOT = NUM_ATTRIBUTE_SLOTS   /**< @brief Returned for all other keys */
+} AttributeSlot;
+
+/**
+ * @brief Look up the slot for an attribute key
+ *
+ * @param key Attribute key (e.g., "parent")
+ * @returns Slot for the key or @c NO_SLOT if it does not have one
+ */
+AttributeSlot AttributeSlot_from_key (const char* key);
+
+/**
+ * @brief Return the attribute key for a slot
+ *
+ * @param slot Slot to convert
+ * @returns Attribute key (e.g., "parent")
+ */
+const char* AttributeSlot_to_key (AttributeSlot slot);
+
 /**
  * @brief AST attribute (basically a key-value store for nodes)
  */
@@ -466,6 +527,8 @@ typedef struct Attribute
  * - @ref ASTNode_set_printable_attribute
  * - @ref ASTNode_has_attribute
  * - @ref ASTNode_get_attribute
+ * - @ref ASTNode_has_slot
+ * - @ref ASTNode_get_slot
  */
 typedef struct ASTNode
 {
@@ -490,6 +553,33 @@ typedef struct ASTNode
         struct FuncCallNode funccall;
         struct LiteralNode literal;
     };
+
+    /**
+     * @brief Well-known attributes (each entry is either @c NULL or points
+     * into the @c attributes list)
+     */
+    Attribute* slots[NUM_ATTRIBUTE_SLOTS];
+
+    /**
+     * @brief Parent node (or @c NULL for the root or if parent links have not
+     * been set up); kept in sync with the "parent" attribute, which is set by
+     * @c SetParentVisitor
+     */
+    struct ASTNode* parent;
+
+    /**
+     * @brief Innermost symbol table whose scope includes this node (its own
+     * table if it has one) or @c NULL if symbol tables have not been built;
+     * set by @c BuildSymbolTablesVisitor in Project 3
+     */
+    struct SymbolTable* scope;
+
+    /**
+     * @brief Symbol that a location or function call refers to (or @c NULL if
+     * names have not been resolved or the name is undefined); set once by
+     * @c ResolveSymbolsVisitor in Project 3
+     */
+    struct Symbol* symbol;
 } ASTNode;
 
 /*
@@ -505,7 +595,7 @@ DECL_LIST_TYPE(Node, struct ASTNode*)
  * initialized correctly.
  * 
  * Node structures allocated by this or any other allocator must be explicitly
- * freed using @ref ASTNode_free (note that this will recursively free any
+ * freed using @ref ASTNode_free (note that this will also free any
  * children, so it is sufficient to free the root of a tree in order to free
  * the entire tree).
  * 
@@ -595,11 +685,36 @@ void* ASTNode_get_attribute (ASTNode* node, const char* key);
  */
 int ASTNode_get_int_attribute (ASTNode* node, const char* key);
 
+/**
+ * @brief Check to see if a node has a well-known attribute
+ *
+ * Equivalent to @ref ASTNode_has_attribute with the slot's key, but does not
+ * need to search the attribute list.
+ *
+ * @param node Node to check
+ * @param slot Slot to check
+ * @returns True if the node has the requested attribute, false if not
+ */
+bool ASTNode_has_slot (ASTNode* node, AttributeSlot slot);
+
+/**
+ * @brief Retrieve a well-known attribute from a node
+ *
+ * Equivalent to @ref ASTNode_get_attribute with the slot's key, but does not
+ * need to search the attribute list.
+ *
+ * @param node Node to access
+ * @param slot Slot to retrieve
+ * @returns Attribute value
+ */
+void* ASTNode_get_slot (ASTNode* node, AttributeSlot slot);
+
 /**
  * @brief Deallocate an AST node structure
  * 
- * This will recursively free any children, so it is sufficient to free the
- * root of a tree in order to free the entire tree.
+ * This will free any children as well, so it is sufficient to free the root
+ * of a tree in order to free the entire tree. Children are freed without
+ * recursion, so trees of any depth are safe to free.
  * 
  * It is highly recommended that you subsequently set the pointer to @c NULL so
  * that you do not unintentionally dereference an invalid pointer.
@@ -608,4 +723,105 @@ int ASTNode_get_int_attribute (ASTNode* node, const char* key);
  */
 void ASTNode_free (ASTNode* node);
 
+/**
+ * @brief Size (in bytes) of each block of an AST arena
+ */
+#define AST_ARENA_BLOCK_SIZE (64 << 10)
+
+/**
+ * @brief Block of AST arena storage (see @ref ASTArena_alloc)
+ */
+typedef struct ASTArenaBlock
+{
+    size_t used;                    /**< @brief Number of bytes in use */
+    size_t size;                    /**< @brief Number of bytes in @c data */
+    struct ASTArenaBlock* next;     /**< @brief Previously-filled block */
+    max_align_t data[];             /**< @brief Storage */
+} ASTArenaBlock;
+
+/**
+ * @brief Per-compilation arena for AST-lifetime objects
+ *
+ * While an arena is in use (see @ref ASTArena_use), AST nodes, attributes,
+ * parameters, and node and parameter lists are allocated by bumping a pointer
+ * in large blocks instead of with individual @c calloc calls. Freeing any of
+ * them (e.g., with @ref ASTNode_free) does nothing; everything is released at
+ * once by @ref ASTArena_free, which also runs the destructors of all attribute
+ * values.
+ *
+ * Without an arena, every object is allocated and freed individually as
+ * before, which is more useful for tools like valgrind.
+ */
+typedef struct ASTArena
+{
+    ASTArenaBlock* blocks;          /**< @brief Current block (or @c NULL if empty) */
+    Attribute** attributes;         /**< @brief Every attribute allocated in the arena */
+    size_t num_attributes;          /**< @brief Number of entries in @c attributes */
+    size_t attribute_capacity;      /**< @brief Allocated length of @c attributes */
+    size_t bytes;                   /**< @brief Total number of bytes allocated */
+} ASTArena;
+
+/**
+ * @brief Allocate and initialize a new, empty arena
+ *
+ * @returns Allocated arena (not yet in use)
+ */
+ASTArena* ASTArena_new (void);
+
+/**
+ * @brief Allocate all subsequent AST-lifetime objects in an arena
+ *
+ * @param arena Arena to use (or @c NULL to go back to individual allocation)
+ */
+void ASTArena_use (ASTArena* arena);
+
+/**
+ * @brief Allocate zero-filled, suitably-aligned memory from an arena
+ *
+ * @param arena Arena to allocate from
+ * @param size Number of bytes
+ * @returns Pointer to new memory (valid until @ref ASTArena_free)
+ */
+void* ASTArena_alloc (ASTArena* arena, size_t size);
+
+/**
+ * @brief Test whether memory was allocated from an arena
+ *
+ * @param arena Arena to check (can be @c NULL)
+ * @param ptr Pointer to test
+ * @returns True if @p ptr points into one of the arena's blocks
+ */
+bool ASTArena_owns (ASTArena* arena, void* ptr);
+
+/**
+ * @brief Run the destructors of all attribute values in an arena and
+ * deallocate it along with everything allocated from it
+ *
+ * If the arena is in use, subsequent objects are allocated individually.
+ *
+ * @param arena Arena to free (can be @c NULL)
+ */
+void ASTArena_free (ASTArena* arena);
+
+/**
+ * @brief Allocate zero-filled memory from the arena in use (or with @c calloc
+ * if there is none)
+ *
+ * Has the same signature as @c calloc so that it can be used with
+ * @ref DEF_LIST_IMPL_ALLOC.
+ *
+ * @param count Number of elements
+ * @param size Size of each element
+ * @returns Pointer to new memory
+ */
+void* ast_calloc (size_t count, size_t size);
+
+/**
+ * @brief Deallocate memory from @ref ast_calloc (does nothing if it belongs to
+ * the arena in use)
+ *
+ * @param ptr Pointer to memory
+ */
+void ast_free (void* ptr);
+
 #endif
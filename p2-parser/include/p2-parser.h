@@ -8,9 +8,28 @@
 
 #include "common.h"
 #include "token.h"
+#include "scanner.h"
 #include "ast.h"
 #include "visitor.h"
 
+/**
+ * @brief Expression parsing strategies
+ */
+typedef enum ExprParser
+{
+    EXPR_PRECEDENCE,    /**< @brief Table-driven precedence climbing (default) */
+    EXPR_DESCENT        /**< @brief One recursive function per operator */
+} ExprParser;
+
+/**
+ * @brief Select the expression parser (e.g., to compare the two)
+ *
+ * Both produce identical trees.
+ *
+ * @param impl Expression parser to use
+ */
+void parse_select_expr (ExprParser impl);
+
 /**
  * @brief Convert a queue of tokens into an abstract syntax tree (AST)
  *
@@ -19,4 +38,17 @@
  */
 ASTNode* parse (TokenQueue* input);
 
+/**
+ * @brief Convert tokens into an abstract syntax tree (AST) as they are scanned
+ *
+ * Produces the same tree as @ref parse, but tokens are pulled from the lexer
+ * one at a time, so at most #LEXER_LOOKAHEAD of them are held at once (instead
+ * of a queue of the whole program). Lexing errors are thrown when the parser
+ * reaches them.
+ *
+ * @param input Lexer to read tokens from
+ * @returns Root of abstract syntax tree
+ */
+ASTNode* parse_stream (Lexer* input);
+
 #endif
@@ -0,0 +1,71 @@
+/**
+ * @file scan.h
+ * @brief Byte-scanning kernels used by the lexer
+ *
+ * The kernels process 16 (SSE2) or 32 (AVX2) bytes at a time on x86-64 and
+ * fall back to portable scalar loops elsewhere. The widest implementation
+ * supported by the CPU is selected at run time (via @c cpuid) the first time
+ * a kernel is used.
+ */
+
+#ifndef __SCAN_H
+#define __SCAN_H
+
+#include "common.h"
+
+/**
+ * @brief Kernel implementations that can be selected
+ */
+typedef enum ScanImpl
+{
+    SCAN_AUTO,      /**< @brief Widest implementation supported by the CPU */
+    SCAN_SCALAR,    /**< @brief Portable byte-at-a-time loops */
+    SCAN_SSE2,      /**< @brief 16 bytes at a time */
+    SCAN_AVX2       /**< @brief 32 bytes at a time */
+} ScanImpl;
+
+/**
+ * @brief Select the kernel implementation (e.g., to test the fallbacks)
+ *
+ * Requests for an implementation that the CPU does not support select the
+ * widest supported one instead.
+ *
+ * @param impl Requested implementation
+ * @returns Implementation actually selected
+ */
+ScanImpl scan_select (ScanImpl impl);
+
+/**
+ * @brief Select the widest supported implementation unless one has already
+ * been selected
+ *
+ * The kernels do this lazily on first use, which is not thread-safe; callers
+ * that scan from several threads must call this before starting them.
+ */
+void scan_init (void);
+
+/**
+ * @brief Skip a run of spaces, tabs, and newlines
+ *
+ * @param p Start of run
+ * @param end End of input
+ * @param newlines Incremented by the number of newlines skipped
+ * @param line_start Set to the character after the last newline skipped (left
+ * unchanged if there are none)
+ * @returns First character that is not a space, tab, or newline (or @p end)
+ */
+const char* scan_skip_blanks (const char* p, const char* end, int* newlines, const char** line_start);
+
+/**
+ * @brief Find the first occurrence of a character
+ *
+ * Used to find the end of a comment (@c '\\n') or string literal (@c '"').
+ *
+ * @param p Start of search
+ * @param end End of input
+ * @param c Character to find
+ * @returns First occurrence of @p c (or @p end if there is none)
+ */
+const char* scan_find (const char* p, const char* end, char c);
+
+#endif
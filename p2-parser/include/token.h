@@ -70,6 +70,70 @@ typedef enum TokenType {
     ID, DECLIT, HEXLIT, STRLIT, KEY, SYM
 } TokenType;
 
+/**
+ * @brief Classification of a word (identifier-shaped text)
+ *
+ * Every Decaf keyword has its own value; all reserved words (which may not be
+ * used as identifiers) share @c RESERVED_WORD.
+ */
+typedef enum Keyword {
+    NOT_KEYWORD,
+    KW_DEF, KW_IF, KW_ELSE, KW_WHILE, KW_RETURN, KW_BREAK, KW_CONTINUE,
+    KW_INT, KW_BOOL, KW_VOID, KW_TRUE, KW_FALSE,
+    RESERVED_WORD
+} Keyword;
+
+/**
+ * @brief Classify a word as a keyword, a reserved word, or neither
+ *
+ * Switches on the length and first character of the word, so at most one
+ * string comparison is needed.
+ *
+ * @param text Start of the word (need not be NUL-terminated)
+ * @param len Length of the word
+ * @returns Keyword for the word (or @c NOT_KEYWORD)
+ */
+Keyword Keyword_classify (const char* text, size_t len);
+
+/**
+ * @brief Pre-classified kind of a symbol or keyword token
+ *
+ * Assigned to every token when it is created, so the parser can switch on an
+ * integer instead of comparing text. Every symbol and keyword has its own
+ * value; identifiers and literals are @c TK_NONE.
+ */
+typedef enum TokenKind {
+    TK_NONE,
+    /* operators */
+    TK_OR, TK_AND, TK_EQ, TK_NE, TK_LT, TK_LE, TK_GE, TK_GT,
+    TK_PLUS, TK_MINUS, TK_STAR, TK_SLASH, TK_PERCENT, TK_NOT,
+    /* punctuation */
+    TK_ASSIGN, TK_LPAREN, TK_RPAREN, TK_LBRACKET, TK_RBRACKET,
+    TK_LBRACE, TK_RBRACE, TK_SEMI, TK_COMMA, TK_BACKSLASH,
+    /* keywords */
+    TK_DEF, TK_IF, TK_ELSE, TK_WHILE, TK_RETURN, TK_BREAK, TK_CONTINUE,
+    TK_INT, TK_BOOL, TK_VOID, TK_TRUE, TK_FALSE,
+    NUM_TOKEN_KINDS
+} TokenKind;
+
+/**
+ * @brief Classify the text of a token
+ *
+ * @param type Type of the token
+ * @param text Start of the text (need not be NUL-terminated)
+ * @param len Length of the text
+ * @returns Kind of the token (or @c TK_NONE)
+ */
+TokenKind TokenKind_classify (TokenType type, const char* text, size_t len);
+
+/**
+ * @brief Convert a token kind to its source text (for error messages)
+ *
+ * @param kind Kind to convert
+ * @returns Static const string (empty for @c TK_NONE)
+ */
+const char* TokenKind_to_string (TokenKind kind);
+
 /**
  * @brief Single token
  * 
@@ -97,8 +161,67 @@ typedef struct Token
      */
     struct Token* next;
 
+    /**
+     * @brief True if the token belongs to a queue's arena (see
+     * @ref TokenQueue_add_span); @ref Token_free ignores such tokens
+     */
+    bool in_arena;
+
+    /**
+     * @brief Pre-classified kind (see @ref TokenKind_classify)
+     */
+    TokenKind kind;
+
+    /**
+     * @brief Block that @ref Token_new carved the token out of (or @c NULL)
+     */
+    struct TokenBlock* block;
+
 } Token;
 
+/**
+ * @brief Compact token that refers to its text in the source buffer
+ *
+ * Unlike @ref Token, a span does not copy its text; use
+ * @ref TokenSpan_text to materialize it or @ref TokenSpan_text_eq to compare
+ * it against a string. The source buffer must outlive the span.
+ *
+ * The source-built parser reads spans straight from a lexer (see
+ * @c parse_stream); spans are only copied into a @ref Token when they are
+ * queued, because the precompiled objects read @ref Token::text in place.
+ */
+typedef struct TokenSpan
+{
+    TokenType type;     /**< @brief Type of the token */
+    TokenKind kind;     /**< @brief Pre-classified kind (see @ref TokenKind_classify) */
+    size_t offset;      /**< @brief Offset of the first character in the source */
+    size_t length;      /**< @brief Number of characters */
+    int line;           /**< @brief Source line number */
+    int column;         /**< @brief Source column number (1-based) */
+} TokenSpan;
+
+/**
+ * @brief Copy the text of a token span into a string buffer
+ *
+ * Text longer than a token can hold is truncated.
+ *
+ * @param source Source buffer that the span refers to
+ * @param span Token span
+ * @param buffer Character buffer (must be at least #MAX_TOKEN_LEN long)
+ * @returns @p buffer
+ */
+char* TokenSpan_text (const char* source, const TokenSpan* span, char* buffer);
+
+/**
+ * @brief Compare the text of a token span against a string without copying it
+ *
+ * @param source Source buffer that the span refers to
+ * @param span Token span
+ * @param str String to compare against
+ * @returns True if the span's text equals @p str
+ */
+bool TokenSpan_text_eq (const char* source, const TokenSpan* span, const char* str);
+
 /**
  * @brief Convert a token type to a string for output
  *
@@ -123,6 +246,10 @@ bool token_str_eq(const char* str1, const char* str2);
  * Make sure Token_free() is called to deallocate the token, otherwise there
  * will be a memory leak.
  *
+ * Tokens are carved out of shared blocks of #TOKEN_BLOCK_SIZE tokens, and a
+ * block is deallocated when all of its tokens have been freed, so this is not
+ * thread-safe.
+ *
  * @param type Type of new token
  * @param text Raw text for new token
  * @param line Line number of new token
@@ -138,12 +265,44 @@ Token* Token_new (TokenType type, const char* text, int line);
 void Token_free (Token* token);
 
 /**
- * @brief Linked list of tokens
+ * @brief Print a token to the given file descriptor (debug output)
+ *
+ * @param token Token to print
+ * @param out File stream to print to
+ */
+void Token_print (Token* token, FILE* out);
+
+/**
+ * @brief Number of tokens in each block of storage
+ */
+#define TOKEN_BLOCK_SIZE 256
+
+/**
+ * @brief Fixed-size block of token storage (see @ref Token_new and
+ * @ref TokenQueue_add_span)
+ */
+typedef struct TokenBlock
+{
+    Token tokens[TOKEN_BLOCK_SIZE];     /**< @brief Token storage */
+    size_t used;                        /**< @brief Number of tokens in use */
+    struct TokenBlock* next;            /**< @brief Previously-filled block */
+    size_t live;                        /**< @brief Number of tokens from @ref Token_new not yet freed */
+} TokenBlock;
+
+/**
+ * @brief Queue of tokens
+ *
+ * Tokens are linked in order through their @c next pointers, and are also
+ * indexed by an array so that the size and arbitrary lookahead are O(1).
+ * Tokens added with @ref TokenQueue_add_span are stored contiguously in an
+ * arena owned by the queue and are all deallocated at once by
+ * @ref TokenQueue_free.
  * 
  * Allocate with @ref TokenQueue_new and de-allocate with @ref TokenQueue_free.
  * 
  * Methods:
  * - @ref TokenQueue_peek
+ * - @ref TokenQueue_peek_ahead
  * - @ref TokenQueue_remove
  * - @ref TokenQueue_is_empty
  * - @ref TokenQueue_size
@@ -161,6 +320,32 @@ typedef struct TokenQueue
      */
     Token* tail;
 
+    /**
+     * @brief Every token ever added, in order (@c capacity entries allocated)
+     */
+    Token** items;
+
+    /**
+     * @brief Number of tokens ever added
+     */
+    size_t count;
+
+    /**
+     * @brief Allocated length of @c items
+     */
+    size_t capacity;
+
+    /**
+     * @brief Index of the front token in @c items
+     */
+    size_t cursor;
+
+    /**
+     * @brief Current arena block (or <tt>NULL</tt> if no tokens were added
+     * with @ref TokenQueue_add_span)
+     */
+    TokenBlock* blocks;
+
 } TokenQueue;
 
 /**
@@ -178,6 +363,19 @@ TokenQueue* TokenQueue_new (void);
  */
 void TokenQueue_add (TokenQueue* queue, Token* token);
 
+/**
+ * @brief Create a token from a token span in the queue's arena and add it
+ *
+ * This avoids a separate allocation per token. The token is deallocated with
+ * the queue (calling @ref Token_free on it has no effect), so it must not be
+ * used after @ref TokenQueue_free.
+ *
+ * @param queue Queue to add to
+ * @param source Source buffer that the span refers to
+ * @param span Token span
+ */
+void TokenQueue_add_span (TokenQueue* queue, const char* source, const TokenSpan* span);
+
 /**
  * @brief Return the next token from a queue without removing it
  * (first-in-first-out)
@@ -187,6 +385,16 @@ void TokenQueue_add (TokenQueue* queue, Token* token);
  */
 Token* TokenQueue_peek (TokenQueue* queue);
 
+/**
+ * @brief Look ahead in a queue without removing any tokens
+ *
+ * @param queue Queue to look at
+ * @param k Number of tokens to skip (0 is the same as @ref TokenQueue_peek)
+ * @returns Token @p k positions from the front (or @c NULL if there are not
+ * enough tokens)
+ */
+Token* TokenQueue_peek_ahead (TokenQueue* queue, size_t k);
+
 /**
  * @brief Remove a token from a queue (first-in-first-out)
  *
@@ -34,31 +34,6 @@ void Error_throw_printf (const char* format, ...)
     longjmp(decaf_error, 1);
 }
 
-/**
- * @brief Read all text data from a file
- *
- * @param filename Name of file to read
- * @param text String buffer destination (must be #MAX_FILE_SIZE characters long)
- * @returns True if and only if the file read was successful.
- */
-bool read_file (const char* filename, char* text)
-{
-    FILE* input = fopen(filename, "r");
-    if (input == NULL) {
-        return false;
-    }
-    size_t nchars = 0;
-    char* p = text;
-    int c;
-    while (nchars < MAX_FILE_SIZE && (c = fgetc(input)) != EOF) {
-        *p++ = (char)c;
-        nchars++;
-    }
-    *p = '\0';
-    fclose(input);
-    return true;
-}
-
 /**
  * @brief Compiler entry point
  *
@@ -77,42 +52,51 @@ int main(int argc, char** argv)
     char* filename = argv[argc-1];
 
     /* read file */
-    char text[MAX_FILE_SIZE];
-    if (!read_file(filename, text)) {
+    SourceText* source = SourceText_read(filename);
+    if (source == NULL) {
         fprintf(stderr, "Could not read file: %s", filename);
         exit(EXIT_FAILURE);
     }
 
+    /* allocate the AST in an arena (set DECAF_NO_ARENA in the environment to
+     * allocate each object individually, e.g., for valgrind) */
+    ASTArena* arena = (getenv("DECAF_NO_ARENA") == NULL ? ASTArena_new() : NULL);
+    ASTArena_use(arena);
+
     /* FRONT END */
 
-    TokenQueue* tokens = NULL;
+    Lexer* lexer = NULL;
     ASTNode* tree = NULL;
 
     /* fatal errors are possible in the front end, so check for them */
     if (setjmp(decaf_error) == 0) {
 
-        /* PROJECT 1: lexer */
-        tokens = lex(text);
-
-        /* PROJECT 2: parser */
-        tree = parse(tokens);
+        /* PROJECTS 1 and 2: lexer and parser (tokens are scanned as the
+         * parser asks for them, so only a few are held at once) */
+        lexer = Lexer_new(source->text, source->length, LEX_DECAF);
+        tree = parse_stream(lexer);
 
     } else {
 
         /* handle fatal error: print message and clean up */
         fprintf(stderr, "%s", decaf_error_msg);
-        if (tokens   != NULL) TokenQueue_free(tokens);
+        if (lexer    != NULL) Lexer_free(lexer);
+        if (source   != NULL) SourceText_free(source);
         if (tree     != NULL) ASTNode_free(tree);
+        ASTArena_free(arena);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
-    /* clean up tokens (no longer needed) */
-    TokenQueue_free(tokens);
-    tokens = NULL;
+    /* clean up lexer and source text (no longer needed) */
+    Lexer_free(lexer);
+    lexer = NULL;
+    SourceText_free(source);
+    source = NULL;
 
-    /* set up parent links and calculate node depths */
-    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
-    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+    /* set up parent links and calculate node depths (in a single traversal) */
+    NodeVisitor_traverse_and_free(FusedVisitor_new(2,
+            SetParentVisitor_new(), CalcDepthVisitor_new()), tree);
 
     /* 
      * output (disable attribute printing in this phase (keeps AST output
@@ -133,6 +117,8 @@ int main(int argc, char** argv)
 
     /* clean up */
     ASTNode_free(tree);
+    ASTArena_free(arena);
+    free_interned_strings();
 
     return EXIT_SUCCESS;
 }
@@ -6,60 +6,217 @@
  */
 
 #include "p2-parser.h"
+
+/**
+ * @brief Token as seen by the parser
+ *
+ * The text is not copied: it points into the source text (for a lexer) or into
+ * a queued token, and is valid until the next token is removed.
+ */
+typedef struct TokenView
+{
+    TokenType type;         /**< @brief Type of the token */
+    TokenKind kind;         /**< @brief Pre-classified kind */
+    int line;               /**< @brief Source line number */
+    const char* text;       /**< @brief Start of the text (not NUL-terminated) */
+    int length;             /**< @brief Length of the text */
+} TokenView;
+
+/**
+ * @brief Tokens read by the parser: either a queue that was lexed in advance
+ * (see @ref parse) or a lexer that scans them on demand (see @ref parse_stream)
+ */
+typedef struct TokenStream
+{
+    TokenQueue* queue;      /**< @brief Queue to read from (or NULL) */
+    Lexer* lexer;           /**< @brief Lexer to read from (or NULL) */
+    Token* removed;         /**< @brief Last token removed from @c queue */
+} TokenStream;
+
+/**
+ * @brief Fill in a view of a queued token
+ */
+void view_token (Token* token, TokenView* view)
+{
+    view->type = token->type;
+    view->kind = token->kind;
+    view->line = token->line;
+    view->text = token->text;
+    view->length = strlen(token->text);
+}
+
+/**
+ * @brief Fill in a view of a token span
+ *
+ * Text longer than a token can hold is cut off (as it would be in a queued
+ * token).
+ */
+void view_span (const char* source, const TokenSpan* span, TokenView* view)
+{
+    view->type = span->type;
+    view->kind = span->kind;
+    view->line = span->line;
+    view->text = source + span->offset;
+    view->length = (span->length < MAX_TOKEN_LEN ? span->length : MAX_TOKEN_LEN - 1);
+}
+
+/**
+ * @brief Check whether there are no more tokens
+ *
+ * @param input Token stream to examine
+ * @returns True if the stream is empty
+ */
+bool stream_is_empty (TokenStream* input)
+{
+    if (input->lexer != NULL) {
+        return Lexer_peek_span(input->lexer, 0) == NULL;
+    }
+    return TokenQueue_is_empty(input->queue);
+}
+
+/**
+ * @brief Look ahead without removing any tokens
+ *
+ * @param input Token stream to examine
+ * @param k Number of tokens to skip (must be less than #LEXER_LOOKAHEAD)
+ * @param view Destination for the token @p k positions ahead
+ * @returns False if the stream ends first
+ */
+bool stream_peek (TokenStream* input, size_t k, TokenView* view)
+{
+    if (input->lexer != NULL) {
+        const TokenSpan* span = Lexer_peek_span(input->lexer, k);
+        if (span == NULL) {
+            return false;
+        }
+        view_span(input->lexer->scanner.text, span, view);
+        return true;
+    }
+    Token* token = TokenQueue_peek_ahead(input->queue, k);
+    if (token == NULL) {
+        return false;
+    }
+    view_token(token, view);
+    return true;
+}
+
+/**
+ * @brief Look ahead at the kind of a token without removing any tokens
+ *
+ * @param input Token stream to examine
+ * @param k Number of tokens to skip (must be less than #LEXER_LOOKAHEAD)
+ * @returns Kind of the token @p k positions ahead (or @c TK_NONE if the stream
+ * ends first)
+ */
+TokenKind stream_peek_kind (TokenStream* input, size_t k)
+{
+    TokenView view;
+    return stream_peek(input, k, &view) ? view.kind : TK_NONE;
+}
+
+/**
+ * @brief Remove the next token
+ *
+ * The view stays valid until the next token is removed (or the stream is
+ * closed with @ref stream_close).
+ *
+ * @param input Token stream to modify
+ * @param view Destination for the removed token (or @c NULL)
+ * @returns False if the stream is empty
+ */
+bool stream_remove (TokenStream* input, TokenView* view)
+{
+    if (input->lexer != NULL) {
+        TokenSpan span;
+        if (!Lexer_next_span(input->lexer, &span)) {
+            return false;
+        }
+        if (view != NULL) {
+            view_span(input->lexer->scanner.text, &span, view);
+        }
+        return true;
+    }
+    Token_free(input->removed);
+    input->removed = TokenQueue_remove(input->queue);
+    if (input->removed == NULL) {
+        return false;
+    }
+    if (view != NULL) {
+        view_token(input->removed, view);
+    }
+    return true;
+}
+
+/**
+ * @brief Release the last removed token
+ *
+ * @param input Token stream to close
+ */
+void stream_close (TokenStream* input)
+{
+    Token_free(input->removed);
+    input->removed = NULL;
+}
+
 // declaring functions that will be used
-ASTNode* parse_lit(TokenQueue* input);
-ASTNode* parse_expr(TokenQueue* input);
+ASTNode* parse_lit(TokenStream* input);
+ASTNode* parse_expr(TokenStream* input);
 ASTNode* parse(TokenQueue* input);
-ASTNode* parse_block (TokenQueue* input);
-ASTNode* parse_funcCall (TokenQueue* input);
-ASTNode* parse_stmts (TokenQueue* input);
-Token* peek_2_ahead(TokenQueue* input);
-bool check_extra_semi (TokenQueue* input);
-bool check_extra_brace (TokenQueue* input);
-bool check_next_token (TokenQueue* input, TokenType type, const char* text);
-int get_next_token_line (TokenQueue* input);
+ASTNode* parse_block (TokenStream* input);
+ASTNode* parse_funcCall (TokenStream* input);
+ASTNode* parse_stmts (TokenStream* input);
+TokenKind peek_2_ahead(TokenStream* input);
+bool check_extra_semi (TokenStream* input);
+bool check_extra_brace (TokenStream* input);
+bool check_next_token (TokenStream* input, TokenKind kind);
+int get_next_token_line (TokenStream* input);
 
 
+/**
+ * @brief Binary operator and precedence for an operator token
+ */
+typedef struct BinaryOpInfo
+{
+    BinaryOpType op;        /**< @brief Operator */
+    int precedence;         /**< @brief Binding strength (0 if not a binary operator) */
+} BinaryOpInfo;
+
+/**
+ * @brief Binary operators indexed by token kind
+ *
+ * Every operator has its own precedence level (higher binds tighter) to match
+ * the chain of parse_bin_* functions above, and all are left-associative.
+ */
+BinaryOpInfo binary_ops[NUM_TOKEN_KINDS] = {
+    [TK_OR]      = { OROP,  1 },
+    [TK_AND]     = { ANDOP, 2 },
+    [TK_NE]      = { NEQOP, 3 },
+    [TK_EQ]      = { EQOP,  4 },
+    [TK_GT]      = { GTOP,  5 },
+    [TK_GE]      = { GEOP,  6 },
+    [TK_LE]      = { LEOP,  7 },
+    [TK_LT]      = { LTOP,  8 },
+    [TK_MINUS]   = { SUBOP, 9 },
+    [TK_PLUS]    = { ADDOP, 10 },
+    [TK_PERCENT] = { MODOP, 11 },
+    [TK_SLASH]   = { DIVOP, 12 },
+    [TK_STAR]    = { MULOP, 13 },
+};
+
 /**
  * @brief a helper function to check if the next token is a binary operator
  * 
  * @param Input 
  * @return BinaryOpType 
  */
-BinaryOpType helper_get_binary_op_type (TokenQueue* Input) 
+BinaryOpType helper_get_binary_op_type (TokenStream* Input) 
 {
-    Token* token = TokenQueue_peek(Input);
-    if (strcmp(token->text, "||") == 0) {
-        return OROP;
-    } else if (strcmp(token->text, "&&") == 0) {
-        return ANDOP;
-    } else if (strcmp(token->text, "==") == 0) {
-        return EQOP;
-    } else if (strcmp(token->text, "!=") == 0) {
-        return NEQOP;
-    } else if (strcmp(token->text, "<") == 0) {
-        return LTOP;
-    } else if (strcmp(token->text, "<=") == 0) {
-        return LEOP;
-    } else if (strcmp(token->text, ">=") == 0) {
-        return GEOP;
-    } else if (strcmp(token->text, ">") == 0) {
-        return GTOP;
-    } else if (strcmp(token->text, "+") == 0) {
-        return ADDOP;
-    } else if (strcmp(token->text, "-") == 0) {
-        return SUBOP;
-    } else if (strcmp(token->text, "*") == 0) {
-        return MULOP;
-    } else if (strcmp(token->text, "/") == 0) {
-        return DIVOP;
-    } else if (strcmp(token->text, "%") == 0) {
-        return MODOP;
-    } else {
-        Error_throw_printf("Invalid binary operator '%s' on line %d\n", TokenQueue_peek(Input)->text, get_next_token_line(Input));
+    TokenView token;
+    stream_peek(Input, 0, &token);
+    if (binary_ops[token.kind].precedence == 0) {
+        Error_throw_printf("Invalid binary operator '%.*s' on line %d\n", token.length, token.text, get_next_token_line(Input));
     }
-    Error_throw_printf("Invalid binary operator '%s' on line %d\n", TokenQueue_peek(Input)->text, get_next_token_line(Input));
-    return -1;
+    return binary_ops[token.kind].op;
 }
 
 /**
@@ -69,24 +226,8 @@ BinaryOpType helper_get_binary_op_type (TokenQueue* Input)
  * @return true 
  * @return false 
  */
-bool isBinOP(TokenQueue* Input) {
-    Token* token = peek_2_ahead(Input);
-    if (strcmp(token->text, "||") == 0 ||
-        strcmp(token->text, "&&") == 0 ||
-        strcmp(token->text, "==") == 0 ||
-        strcmp(token->text, "!=") == 0 ||
-        strcmp(token->text, "<") == 0 ||
-        strcmp(token->text, "<=") == 0 ||
-        strcmp(token->text, ">=") == 0 ||
-        strcmp(token->text, ">") == 0 ||
-        strcmp(token->text, "+") == 0 ||
-        strcmp(token->text, "-") == 0 ||
-        strcmp(token->text, "*") == 0 ||
-        strcmp(token->text, "/") == 0 ||
-        strcmp(token->text, "%") == 0) {
-        return true;
-    }
-    return false;
+bool isBinOP(TokenStream* Input) {
+    return binary_ops[peek_2_ahead(Input)].precedence > 0;
 }
 
 /**
@@ -95,35 +236,36 @@ bool isBinOP(TokenQueue* Input) {
  * @param input Token queue to examine
  * @returns Source line
  */
-int get_next_token_line (TokenQueue* input)
+int get_next_token_line (TokenStream* input)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input\n");
     }
-    return TokenQueue_peek(input)->line;
+    TokenView token;
+    stream_peek(input, 0, &token);
+    return token.line;
 }
 
 /**
  * @brief Check next token for a particular type and text and discard it
  * 
  * Throws an error if there are no more tokens or if the next token in the
- * queue does not match the given type or text.
+ * queue is not the given symbol or keyword.
  * 
  * @param input Token queue to modify
- * @param type Expected type of next token
- * @param text Expected text of next token
+ * @param kind Expected kind of next token
  */
-void match_and_discard_next_token (TokenQueue* input, TokenType type, const char* text)
+void match_and_discard_next_token (TokenStream* input, TokenKind kind)
 {
-    if (TokenQueue_is_empty(input)) {
-        Error_throw_printf("Unexpected end of input (expected \'%s\')\n", text);
+    if (stream_is_empty(input)) {
+        Error_throw_printf("Unexpected end of input (expected \'%s\')\n", TokenKind_to_string(kind));
     }
-    Token* token = TokenQueue_remove(input);
-    if (token->type != type || !token_str_eq(token->text, text)) {
-        Error_throw_printf("Expected \'%s\' but found '%s' on line %d\n",
-                text, token->text, get_next_token_line(input));
+    TokenView token;
+    stream_remove(input, &token);
+    if (token.kind != kind) {
+        Error_throw_printf("Expected \'%s\' but found '%.*s' on line %d\n",
+                TokenKind_to_string(kind), token.length, token.text, get_next_token_line(input));
     }
-    Token_free(token);
 }
 
 /**
@@ -133,12 +275,12 @@ void match_and_discard_next_token (TokenQueue* input, TokenType type, const char
  * 
  * @param input Token queue to modify
  */
-void discard_next_token (TokenQueue* input)
+void discard_next_token (TokenStream* input)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input\n");
     }
-    Token_free(TokenQueue_remove(input));
+    stream_remove(input, NULL);
 }
 
 /**
@@ -148,30 +290,29 @@ void discard_next_token (TokenQueue* input)
  * @param type Expected type of next token
  * @returns True if the next token is of the expected type, false if not
  */
-bool check_next_token_type (TokenQueue* input, TokenType type)
+bool check_next_token_type (TokenStream* input, TokenType type)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         return false;
     }
-    Token* token = TokenQueue_peek(input);
-    return (token->type == type);
+    TokenView token;
+    stream_peek(input, 0, &token);
+    return (token.type == type);
 }
 
 /**
- * @brief Look ahead at the type and text of the next token
+ * @brief Look ahead at the kind of the next token
  * 
  * @param input Token queue to examine
- * @param type Expected type of next token
- * @param text Expected text of next token
- * @returns True if the next token is of the expected type and text, false if not
+ * @param kind Expected kind of next token (a symbol or keyword)
+ * @returns True if the next token is of the expected kind, false if not
  */
-bool check_next_token (TokenQueue* input, TokenType type, const char* text)
+bool check_next_token (TokenStream* input, TokenKind kind)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         return false;
     }
-    Token* token = TokenQueue_peek(input);
-    return (token->type == type) && (token_str_eq(token->text, text));
+    return stream_peek_kind(input, 0) == kind;
 }
 
 /**
@@ -180,26 +321,21 @@ bool check_next_token (TokenQueue* input, TokenType type, const char* text)
  * @param input Token queue to modify
  * @returns Parsed type (it is also removed from the queue)
  */
-DecafType parse_type (TokenQueue* input)
+DecafType parse_type (TokenStream* input)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected type)\n");
     }
-    Token* token = TokenQueue_remove(input);
-    if (token->type != KEY) {
-        Error_throw_printf("Invalid type '%s' on line %d\n", token->text, get_next_token_line(input));
-    }
+    TokenView token;
+    stream_remove(input, &token);
     DecafType t = VOID;
-    if (token_str_eq("int", token->text)) {
-        t = INT;
-    } else if (token_str_eq("bool", token->text)) {
-        t = BOOL;
-    } else if (token_str_eq("void", token->text)) {
-        t = VOID;
-    } else {
-        Error_throw_printf("Invalid type '%s' on line %d\n", token->text, get_next_token_line(input));
+    switch (token.kind) {
+        case TK_INT:  t = INT;  break;
+        case TK_BOOL: t = BOOL; break;
+        case TK_VOID: t = VOID; break;
+        default:
+            Error_throw_printf("Invalid type '%.*s' on line %d\n", token.length, token.text, get_next_token_line(input));
     }
-    Token_free(token);
     return t;
 }
 
@@ -210,17 +346,17 @@ DecafType parse_type (TokenQueue* input)
  * @param buffer String buffer for parsed identifier (should be at least
  * @c MAX_TOKEN_LEN characters long)
  */
-void parse_id (TokenQueue* input, char* buffer)
+void parse_id (TokenStream* input, char* buffer)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected identifier)\n");
     }
-    Token* token = TokenQueue_remove(input);
-    if (token->type != ID) {
-        Error_throw_printf("Invalid ID '%s' on line %d\n", token->text, get_next_token_line(input));
+    TokenView token;
+    stream_remove(input, &token);
+    if (token.type != ID) {
+        Error_throw_printf("Invalid ID '%.*s' on line %d\n", token.length, token.text, get_next_token_line(input));
     }
-    snprintf(buffer, MAX_ID_LEN, "%s", token->text);
-    Token_free(token);
+    snprintf(buffer, MAX_ID_LEN, "%.*s", token.length, token.text);
 }
 
 
@@ -230,28 +366,29 @@ void parse_id (TokenQueue* input, char* buffer)
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_vardecl(TokenQueue* input)
+ASTNode* parse_vardecl(TokenStream* input)
 {
     DecafType temp = parse_type(input);
     char buffer[MAX_ID_LEN];
 
     parse_id(input, buffer);
     int line = get_next_token_line(input);
-    Token* token = NULL;
     bool is_array = false;
     int array_length = 1;
-    if (check_next_token(input, SYM, "[")) {
-        match_and_discard_next_token(input, SYM, "[");
-        token = TokenQueue_remove(input);
-        array_length = atoi(token->text);
+    if (check_next_token(input, TK_LBRACKET)) {
+        match_and_discard_next_token(input, TK_LBRACKET);
+        TokenView token;
+        char length_text[MAX_TOKEN_LEN];
+        stream_remove(input, &token);
+        snprintf(length_text, MAX_TOKEN_LEN, "%.*s", token.length, token.text);
+        array_length = atoi(length_text);
         is_array = true;
-        match_and_discard_next_token(input, SYM, "]");
+        match_and_discard_next_token(input, TK_RBRACKET);
     }
-    match_and_discard_next_token(input, SYM, ";");
+    match_and_discard_next_token(input, TK_SEMI);
     if (check_extra_semi(input)) {
         Error_throw_printf("Unexpected semicolon on line %d\n", get_next_token_line(input));
     }
-    Token_free(token);
     
     return VarDeclNode_new(buffer, temp, is_array, array_length, line);
 }
@@ -262,23 +399,23 @@ ASTNode* parse_vardecl(TokenQueue* input)
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_loc (TokenQueue* input) {
+ASTNode* parse_loc (TokenStream* input) {
     char buffer[MAX_ID_LEN];
     parse_id(input, buffer);
     int line = get_next_token_line(input);
 
-    if (check_next_token(input, SYM, "[")) {
-        match_and_discard_next_token(input, SYM, "[");
+    if (check_next_token(input, TK_LBRACKET)) {
+        match_and_discard_next_token(input, TK_LBRACKET);
         ASTNode* index = parse_expr(input);
         // ArrayAssignment checker
-        if (check_next_token(input, SYM, "[")) {
-            match_and_discard_next_token(input, SYM, "[");
+        if (check_next_token(input, TK_LBRACKET)) {
+            match_and_discard_next_token(input, TK_LBRACKET);
             ASTNode* index2 = parse_expr(input);
-            match_and_discard_next_token(input, SYM, "]");
-            match_and_discard_next_token(input, SYM, "]");
+            match_and_discard_next_token(input, TK_RBRACKET);
+            match_and_discard_next_token(input, TK_RBRACKET);
             return LocationNode_new(buffer, BinaryOpNode_new(ADDOP, index, index2, line), line);
         }
-        match_and_discard_next_token(input, SYM, "]");
+        match_and_discard_next_token(input, TK_RBRACKET);
         return LocationNode_new(buffer, index, line);
     } 
     
@@ -291,31 +428,36 @@ ASTNode* parse_loc (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_lit(TokenQueue* input)
+ASTNode* parse_lit(TokenStream* input)
 {
-    if (TokenQueue_is_empty(input)) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected literal) on line %d\n", get_next_token_line(input) - 1);
     }
     int line = get_next_token_line(input);
-    Token* token = TokenQueue_remove(input);
+    TokenView token;
+    stream_remove(input, &token);
     ASTNode* node = NULL;
 
-    if (token->type == DECLIT) { // Decimal 
-        int temp = atoi(token->text);
+    // copy out the text (which is not NUL-terminated and may be modified)
+    char text[MAX_TOKEN_LEN];
+    snprintf(text, MAX_TOKEN_LEN, "%.*s", token.length, token.text);
+
+    if (token.type == DECLIT) { // Decimal 
+        int temp = atoi(text);
         node = LiteralNode_new_int(temp, line);
     
-    } else if (token->type == HEXLIT) { // Hexadecimal 
-        int temp = strtol(token->text, NULL, 16);
+    } else if (token.type == HEXLIT) { // Hexadecimal 
+        int temp = strtol(text, NULL, 16);
         node = LiteralNode_new_int(temp, line);
     
-    } else if (strcmp(token->text, "true") == 0) { // true
+    } else if (token.kind == TK_TRUE) { // true
         node = LiteralNode_new_bool(true, line);
 
-    } else if (strcmp(token->text, "false") == 0) { // false 
+    } else if (token.kind == TK_FALSE) { // false 
         node = LiteralNode_new_bool(false, line);
 
-    } else if (token->type == STRLIT) { // String
-        char* temp = token->text;
+    } else if (token.type == STRLIT) { // String
+        char* temp = text;
         // Remove quotes
         if (temp[0] == '"') {
             temp++;
@@ -353,11 +495,9 @@ ASTNode* parse_lit(TokenQueue* input)
         node = LiteralNode_new_string(temp, line);
     
     } else {
-        Token_free(token);
-        Error_throw_printf("Invalid literal '%s' on line %d\n", token->text, line);
+        Error_throw_printf("Invalid literal '%s' on line %d\n", text, line);
     }
 
-    Token_free(token);
     return node; 
 }
 
@@ -367,15 +507,15 @@ ASTNode* parse_lit(TokenQueue* input)
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_baseExpr (TokenQueue* input) {
-    Token* token = peek_2_ahead(input);
-    if (check_next_token(input, SYM, "(")) {
-        match_and_discard_next_token(input, SYM, "(");
+ASTNode* parse_baseExpr (TokenStream* input) {
+    TokenKind next_kind = peek_2_ahead(input);
+    if (check_next_token(input, TK_LPAREN)) {
+        match_and_discard_next_token(input, TK_LPAREN);
         ASTNode* expr = parse_expr(input);
-        match_and_discard_next_token(input, SYM, ")");
+        match_and_discard_next_token(input, TK_RPAREN);
         return expr;
     } else if (check_next_token_type(input, ID)) {
-        if (strcmp(token->text, "(") == 0) {
+        if (next_kind == TK_LPAREN) {
             ASTNode* func = parse_funcCall(input);
             return func;
         }
@@ -392,19 +532,19 @@ ASTNode* parse_baseExpr (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_unaryExpr (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_unaryExpr (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
-    Token* token = TokenQueue_peek(input);
-    if (strcmp(token->text, "-") == 0) { // Negative
-        match_and_discard_next_token(input, SYM, "-");
-        return UnaryOpNode_new(NEGOP, parse_baseExpr(input), get_next_token_line(input));
-    } else if (strcmp(token->text, "!") == 0) { // Not
-        match_and_discard_next_token(input, SYM, "!");
-        return UnaryOpNode_new(NOTOP, parse_baseExpr(input), get_next_token_line(input));
-    } else {
-        return parse_baseExpr(input);
+    switch (stream_peek_kind(input, 0)) {
+        case TK_MINUS: // Negative
+            discard_next_token(input);
+            return UnaryOpNode_new(NEGOP, parse_baseExpr(input), get_next_token_line(input));
+        case TK_NOT: // Not
+            discard_next_token(input);
+            return UnaryOpNode_new(NOTOP, parse_baseExpr(input), get_next_token_line(input));
+        default:
+            return parse_baseExpr(input);
     }
 }
 
@@ -414,14 +554,14 @@ ASTNode* parse_unaryExpr (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_mul (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_bin_mul (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
     int line = get_next_token_line(input);
 
     ASTNode* leftExpr = parse_unaryExpr(input);
-    while (check_next_token(input, SYM, "*")) {
+    while (check_next_token(input, TK_STAR)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_unaryExpr(input);
@@ -436,15 +576,15 @@ ASTNode* parse_bin_mul (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_div (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_bin_div (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
     int line = get_next_token_line(input);
 
     ASTNode* leftExpr = parse_bin_mul(input);
 
-    while (check_next_token(input, SYM, "/")) {
+    while (check_next_token(input, TK_SLASH)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_mul(input);
@@ -459,11 +599,11 @@ ASTNode* parse_bin_div (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_mod (TokenQueue* input) {
+ASTNode* parse_bin_mod (TokenStream* input) {
+    int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_div(input);
-        int line = get_next_token_line(input);
 
-    while (check_next_token(input, SYM, "%")) {
+    while (check_next_token(input, TK_PERCENT)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_div(input);
@@ -478,11 +618,11 @@ ASTNode* parse_bin_mod (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_add (TokenQueue* input) {
+ASTNode* parse_bin_add (TokenStream* input) {
         int line = get_next_token_line(input);
 
     ASTNode* leftExpr = parse_bin_mod(input);
-    while (check_next_token(input, SYM, "+")) {
+    while (check_next_token(input, TK_PLUS)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_mod(input);
@@ -497,14 +637,14 @@ ASTNode* parse_bin_add (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_subtract (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_bin_subtract (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
     int line = get_next_token_line(input);
 
     ASTNode* leftExpr = parse_bin_add(input);
-    while (check_next_token(input, SYM, "-")) {
+    while (check_next_token(input, TK_MINUS)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_add(input);
@@ -519,14 +659,14 @@ ASTNode* parse_bin_subtract (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_less_than (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_bin_less_than (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
     int line = get_next_token_line(input);
 
     ASTNode* leftExpr = parse_bin_subtract(input);
-    while (check_next_token(input, SYM, "<") ) {
+    while (check_next_token(input, TK_LT) ) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_subtract(input);
@@ -541,10 +681,10 @@ ASTNode* parse_bin_less_than (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_less_than_eq (TokenQueue* input) {
+ASTNode* parse_bin_less_than_eq (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_less_than(input);
-    while (check_next_token(input, SYM, "<=")) {
+    while (check_next_token(input, TK_LE)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_less_than(input);
@@ -559,10 +699,10 @@ ASTNode* parse_bin_less_than_eq (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_greater_than_eq (TokenQueue* input) {
+ASTNode* parse_bin_greater_than_eq (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_less_than_eq(input);
-    while (check_next_token(input, SYM, ">=")) {
+    while (check_next_token(input, TK_GE)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_less_than_eq(input);
@@ -577,10 +717,10 @@ ASTNode* parse_bin_greater_than_eq (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_greater_than (TokenQueue* input) {
+ASTNode* parse_bin_greater_than (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_greater_than_eq(input);
-    while (check_next_token(input, SYM, ">")) {
+    while (check_next_token(input, TK_GT)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_greater_than_eq(input);
@@ -595,10 +735,10 @@ ASTNode* parse_bin_greater_than (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_equals (TokenQueue* input) {
+ASTNode* parse_bin_equals (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_greater_than(input);
-    while (check_next_token(input, SYM, "==")) {
+    while (check_next_token(input, TK_EQ)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_greater_than(input);
@@ -613,10 +753,10 @@ ASTNode* parse_bin_equals (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_not_eq (TokenQueue* input) {
+ASTNode* parse_bin_not_eq (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_equals(input);
-    while (check_next_token(input, SYM, "!=")) {
+    while (check_next_token(input, TK_NE)) {
         BinaryOpType operatorToken = helper_get_binary_op_type(input);
         discard_next_token(input);
         ASTNode* rightExpr = parse_bin_equals(input);
@@ -631,11 +771,11 @@ ASTNode* parse_bin_not_eq (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_conjunction (TokenQueue* input) {
+ASTNode* parse_bin_conjunction (TokenStream* input) {
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_not_eq(input);
-    while (check_next_token(input, SYM, "&&")) {
-        match_and_discard_next_token(input, SYM, "&&");
+    while (check_next_token(input, TK_AND)) {
+        match_and_discard_next_token(input, TK_AND);
         ASTNode* rightExpr = parse_bin_not_eq(input);
         leftExpr = BinaryOpNode_new(ANDOP, leftExpr, rightExpr, line);
     }
@@ -648,28 +788,69 @@ ASTNode* parse_bin_conjunction (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_bin_disjunction (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_bin_disjunction (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected expression)\n");
     }
     int line = get_next_token_line(input);
     ASTNode* leftExpr = parse_bin_conjunction(input);
-    while (check_next_token(input, SYM, "||")) {
-        match_and_discard_next_token(input, SYM, "||");
+    while (check_next_token(input, TK_OR)) {
+        match_and_discard_next_token(input, TK_OR);
         ASTNode* rightExpr = parse_bin_conjunction(input);
         leftExpr = BinaryOpNode_new(OROP, leftExpr, rightExpr, line);
     }
     return leftExpr;
 }
 
+/**
+ * @brief parse binary operators by precedence climbing
+ *
+ * Produces the same trees (including line numbers) as the parse_bin_* chain
+ * with a single table lookup per operator.
+ *
+ * @param input
+ * @param min_precedence Lowest precedence of operators to consume
+ * @return ASTNode*
+ */
+ASTNode* parse_bin_climb (TokenStream* input, int min_precedence) {
+    if (stream_is_empty(input)) {
+        Error_throw_printf("Unexpected end of input (expected expression)\n");
+    }
+    int line = get_next_token_line(input);
+    ASTNode* leftExpr = parse_unaryExpr(input);
+    while (!stream_is_empty(input)) {
+        BinaryOpInfo* info = &binary_ops[stream_peek_kind(input, 0)];
+        if (info->precedence < min_precedence) {
+            break;
+        }
+        discard_next_token(input);
+        ASTNode* rightExpr = parse_bin_climb(input, info->precedence + 1);
+        leftExpr = BinaryOpNode_new(info->op, leftExpr, rightExpr, line);
+    }
+    return leftExpr;
+}
+
+/**
+ * @brief Expression parser used by parse_expr
+ */
+ExprParser expr_parser = EXPR_PRECEDENCE;
+
+void parse_select_expr (ExprParser impl)
+{
+    expr_parser = impl;
+}
+
 /**
  * @brief parse expression
  * 
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_expr (TokenQueue* input) {
-    return parse_bin_disjunction(input);
+ASTNode* parse_expr (TokenStream* input) {
+    if (expr_parser == EXPR_DESCENT) {
+        return parse_bin_disjunction(input);
+    }
+    return parse_bin_climb(input, 1);
 }
 
 /**
@@ -678,21 +859,21 @@ ASTNode* parse_expr (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_funcCall (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_funcCall (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected function call)\n");
     }
     char buffer[MAX_ID_LEN];
     parse_id(input, buffer);
-    match_and_discard_next_token(input, SYM, "(");
+    match_and_discard_next_token(input, TK_LPAREN);
     NodeList* args = NodeList_new();
-    while (!check_next_token(input, SYM, ")")) {
+    while (!check_next_token(input, TK_RPAREN)) {
         NodeList_add(args, parse_expr(input));
-        if (check_next_token(input, SYM, ",")) {
-            match_and_discard_next_token(input, SYM, ",");
+        if (check_next_token(input, TK_COMMA)) {
+            match_and_discard_next_token(input, TK_COMMA);
         }
     }
-    match_and_discard_next_token(input, SYM, ")");
+    match_and_discard_next_token(input, TK_RPAREN);
     return FuncCallNode_new(buffer, args, get_next_token_line(input));
 }
 
@@ -700,11 +881,10 @@ ASTNode* parse_funcCall (TokenQueue* input) {
  * @brief method to peek 2 ahead to see if the next one is either a [ or (
  * 
  * @param input 
- * @return Token* 
+ * @return TokenKind (TK_NONE if there is no such token)
  */
-Token* peek_2_ahead(TokenQueue* input) {
-    Token* token = TokenQueue_peek(input);
-    return token->next;
+TokenKind peek_2_ahead(TokenStream* input) {
+    return stream_peek_kind(input, 1);
 }
 
 /**
@@ -714,16 +894,12 @@ Token* peek_2_ahead(TokenQueue* input) {
  * @return true 
  * @return false 
  */
-bool check_extra_semi (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+bool check_extra_semi (TokenStream* input) {
+    if (stream_is_empty(input)) {
         return false;
     }
     
-    Token* token = TokenQueue_peek(input);
-    if (strcmp(token->text, ";") == 0) {
-        return true;
-    }
-    return false;
+    return stream_peek_kind(input, 0) == TK_SEMI;
 }
 
 /**
@@ -733,16 +909,12 @@ bool check_extra_semi (TokenQueue* input) {
  * @return true 
  * @return false 
  */
-bool check_extra_brace_close (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+bool check_extra_brace_close (TokenStream* input) {
+    if (stream_is_empty(input)) {
         return false;
     }
     
-    Token* token = TokenQueue_peek(input);
-    if (strcmp(token->text, "}") == 0) {
-        return true;
-    }
-    return false;
+    return stream_peek_kind(input, 0) == TK_RBRACE;
 }
 
 /**
@@ -752,16 +924,12 @@ bool check_extra_brace_close (TokenQueue* input) {
  * @return true 
  * @return false 
  */
-bool check_extra_brace_open (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+bool check_extra_brace_open (TokenStream* input) {
+    if (stream_is_empty(input)) {
         return false;
     }
     
-    Token* token = TokenQueue_peek(input);
-    if (strcmp(token->text, "{") == 0) {
-        return true;
-    }
-    return false;
+    return stream_peek_kind(input, 0) == TK_LBRACE;
 }
 
 /**
@@ -771,98 +939,107 @@ bool check_extra_brace_open (TokenQueue* input) {
  * @returns Parsed block of statements
  * 
  */
-ASTNode* parse_stmts (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_stmts (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected statement)\n");
     }
-    int line = get_next_token_line(input);         
-    Token* token = peek_2_ahead(input);
+    int line = get_next_token_line(input);
+    TokenKind next_kind = peek_2_ahead(input);
+    TokenKind kind = stream_peek_kind(input, 0);
     // assignment
-    if ((token->type == SYM && strcmp(token->text, "=") == 0)  || strcmp(token->text, "[") == 0) { 
+    if (next_kind == TK_ASSIGN || next_kind == TK_LBRACKET) {
         ASTNode* loc = parse_loc(input);
-        match_and_discard_next_token(input, SYM, "=");
+        match_and_discard_next_token(input, TK_ASSIGN);
         ASTNode* expr = parse_expr(input);
-        match_and_discard_next_token(input, SYM, ";");
+        match_and_discard_next_token(input, TK_SEMI);
         // Checking for extra semicolon
         if (check_extra_semi(input)) {
             Error_throw_printf("Unexpected semicolon on line %d\n", line);
         }
         return AssignmentNode_new(loc, expr, line);
-    } else if (token->type == SYM && strcmp(token->text, "(") == 0  
-        && !check_next_token(input, KEY, "if") 
-        && !check_next_token(input, KEY, "while")) {
+    } else if (next_kind == TK_LPAREN && kind != TK_IF && kind != TK_WHILE) {
             // func call
         ASTNode* func = parse_funcCall(input);
-        match_and_discard_next_token(input, SYM, ";");
+        match_and_discard_next_token(input, TK_SEMI);
         // Checking for extra semicolon
         if (check_extra_semi(input)) {
             Error_throw_printf("Unexpected semicolon on line %d\n", line);
         }
         return func;
-    } else if (check_next_token(input, KEY, "break")) { // Break statement
-        match_and_discard_next_token(input, KEY, "break");
-        match_and_discard_next_token(input, SYM, ";");
-        // Checking for extra semicolon
-        if (check_extra_semi(input)) {
-            Error_throw_printf("Unexpected semicolon on line %d\n", line);
+    }
+
+    switch (kind) {
+        case TK_BREAK: { // Break statement
+            discard_next_token(input);
+            match_and_discard_next_token(input, TK_SEMI);
+            // Checking for extra semicolon
+            if (check_extra_semi(input)) {
+                Error_throw_printf("Unexpected semicolon on line %d\n", line);
+            }
+            return BreakNode_new(line);
         }
-        return BreakNode_new(line);
-    } else if (check_next_token(input, KEY, "continue")) { // Continue statement
-        match_and_discard_next_token(input, KEY, "continue");
-        match_and_discard_next_token(input, SYM, ";");
-        // Checking for extra semicolon
-        if (check_extra_semi(input)) {
-            Error_throw_printf("Unexpected semicolon on line %d\n", line);
+        case TK_CONTINUE: { // Continue statement
+            discard_next_token(input);
+            match_and_discard_next_token(input, TK_SEMI);
+            // Checking for extra semicolon
+            if (check_extra_semi(input)) {
+                Error_throw_printf("Unexpected semicolon on line %d\n", line);
+            }
+            return ContinueNode_new(line);
         }
-        return ContinueNode_new(line);
-    } else if (check_next_token(input, KEY, "return")) { // Return statement
-        match_and_discard_next_token(input, KEY, "return");
-        // Checking if the next token is a semicolon or if its not we need ot parse expression
-        if (check_next_token(input, SYM, ";")) {
-            match_and_discard_next_token(input, SYM, ";");
+        case TK_RETURN: { // Return statement
+            discard_next_token(input);
+            // Checking if the next token is a semicolon or if its not we need ot parse expression
+            if (check_next_token(input, TK_SEMI)) {
+                discard_next_token(input);
+                if (check_extra_semi(input)) {
+                    Error_throw_printf("Unexpected semicolon on line %d\n", line);
+                }
+                return ReturnNode_new(NULL, line);
+            }
+            ASTNode* expr = parse_expr(input);
+            match_and_discard_next_token(input, TK_SEMI);
+            // Checking for extra semicolon
             if (check_extra_semi(input)) {
                 Error_throw_printf("Unexpected semicolon on line %d\n", line);
             }
-            return ReturnNode_new(NULL, line);
+            return ReturnNode_new(expr, line);
         }
-        ASTNode* expr = parse_expr(input);
-        match_and_discard_next_token(input, SYM, ";");
-        // Checking for extra semicolon
-        if (check_extra_semi(input)) {
-            Error_throw_printf("Unexpected semicolon on line %d\n", line);
+        case TK_WHILE: { // While loop
+            discard_next_token(input);
+            // parse condition
+            match_and_discard_next_token(input, TK_LPAREN);
+            ASTNode* condition = parse_expr(input);
+            match_and_discard_next_token(input, TK_RPAREN);
+            // parse block
+            ASTNode* body = parse_block(input);
+            return WhileLoopNode_new(condition, body, line);
         }
-        return ReturnNode_new(expr, line);
-    } else if (check_next_token(input, KEY, "while")) { // While loop
-        match_and_discard_next_token(input, KEY, "while");
-        // parse condition
-        match_and_discard_next_token(input, SYM, "(");
-        ASTNode* condition = parse_expr(input);
-        match_and_discard_next_token(input, SYM, ")");
-        // parse block
-        ASTNode* body = parse_block(input);
-        return WhileLoopNode_new(condition, body, line);
-    } else if (check_next_token(input, KEY, "if")) { // If statement
-        match_and_discard_next_token(input, KEY, "if");
-        // parse condition
-        match_and_discard_next_token(input, SYM, "(");
-        ASTNode* condition = parse_expr(input);
-        match_and_discard_next_token(input, SYM, ")");
-        // parse block
-        ASTNode* if_block = parse_block(input);
-        // parse else block
-        ASTNode* else_block = NULL;
-        if (check_next_token(input, KEY, "else")) {
-            match_and_discard_next_token(input, KEY, "else");
-            Token* token = peek_2_ahead(input);
-            // check if the else block is empty
-            if (strcmp(token->text, "}") == 0) {
-                Error_throw_printf("Empty else block on line %d\n", line);
+        case TK_IF: { // If statement
+            discard_next_token(input);
+            // parse condition
+            match_and_discard_next_token(input, TK_LPAREN);
+            ASTNode* condition = parse_expr(input);
+            match_and_discard_next_token(input, TK_RPAREN);
+            // parse block
+            ASTNode* if_block = parse_block(input);
+            // parse else block
+            ASTNode* else_block = NULL;
+            if (check_next_token(input, TK_ELSE)) {
+                discard_next_token(input);
+                // check if the else block is empty
+                if (peek_2_ahead(input) == TK_RBRACE) {
+                    Error_throw_printf("Empty else block on line %d\n", line);
+                }
+                else_block = parse_block(input);
             }
-            else_block = parse_block(input);
+            return ConditionalNode_new(condition, if_block, else_block, line);
+        }
+        default: {
+            TokenView token;
+            stream_peek(input, 0, &token);
+            Error_throw_printf("Invalid statement \"%.*s\" on line %d\n", token.length, token.text, line);
         }
-        return ConditionalNode_new(condition, if_block, else_block, line);
-    } else {
-        Error_throw_printf("Invalid statement \"%s\" on line %d\n", TokenQueue_peek(input)->text, line);
     }
 
     return NULL;
@@ -874,27 +1051,27 @@ ASTNode* parse_stmts (TokenQueue* input) {
  * @param input Token queue to modify
  * @returns Parsed block of statements
  */
-ASTNode* parse_block (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_block (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected '{')\n");
     }
     // get line number
     int line = get_next_token_line(input);
-    match_and_discard_next_token(input, SYM, "{");
+    match_and_discard_next_token(input, TK_LBRACE);
     if (check_extra_brace_open(input)) {
         Error_throw_printf("Unexpected brace on line %d\n", line);
     }
     NodeList* vars = NodeList_new();
     NodeList* stmts = NodeList_new();
     // check if its an int void or bool
-    while (check_next_token(input, KEY, "int") || check_next_token(input, KEY, "bool") || check_next_token(input, KEY, "void")) {
+    while (check_next_token(input, TK_INT) || check_next_token(input, TK_BOOL) || check_next_token(input, TK_VOID)) {
         NodeList_add(vars, parse_vardecl(input));
     } 
     // parse statements
-    while (!check_next_token(input, SYM, "}")) {
+    while (!check_next_token(input, TK_RBRACE)) {
         NodeList_add(stmts, parse_stmts(input));
     }
-    match_and_discard_next_token(input, SYM, "}");
+    match_and_discard_next_token(input, TK_RBRACE);
     return BlockNode_new(vars, stmts, line);
 }
 
@@ -905,29 +1082,29 @@ ASTNode* parse_block (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_funcdecl (TokenQueue* input) {
-    if (TokenQueue_is_empty(input)) {
+ASTNode* parse_funcdecl (TokenStream* input) {
+    if (stream_is_empty(input)) {
         Error_throw_printf("Unexpected end of input (expected 'def')\n");
     }
     int line = get_next_token_line(input);
-    match_and_discard_next_token(input, KEY, "def");
+    match_and_discard_next_token(input, TK_DEF);
     DecafType return_type = parse_type(input);
     char buffer[MAX_ID_LEN];
     parse_id(input, buffer);
 
-    match_and_discard_next_token(input, SYM, "(");
+    match_and_discard_next_token(input, TK_LPAREN);
 
     // parse_params
     ParameterList* params = ParameterList_new();
     // if it is not the end of the params
-    if (!check_next_token(input, SYM, ")")) {
+    if (!check_next_token(input, TK_RPAREN)) {
         // parse the first param 
         DecafType param_type = parse_type(input);
         char param_buffer[MAX_ID_LEN];
         parse_id(input, param_buffer);
         ParameterList_add_new(params, param_buffer, param_type);
         // Checking for multiple params
-        while (check_next_token(input, SYM, ",")) {
+        while (check_next_token(input, TK_COMMA)) {
             discard_next_token(input); // remove the comma
             param_type = parse_type(input);
             parse_id(input, param_buffer);
@@ -935,7 +1112,7 @@ ASTNode* parse_funcdecl (TokenQueue* input) {
         }
     }
 
-    match_and_discard_next_token(input, SYM, ")");
+    match_and_discard_next_token(input, TK_RPAREN);
 
     return FuncDeclNode_new(buffer, return_type, params, parse_block(input), line);
 }
@@ -946,12 +1123,12 @@ ASTNode* parse_funcdecl (TokenQueue* input) {
  * @param input 
  * @return ASTNode* 
  */
-ASTNode* parse_program (TokenQueue* input)
+ASTNode* parse_program (TokenStream* input)
 {
     NodeList* vars = NodeList_new();
     NodeList* funcs = NodeList_new();
-    while (!TokenQueue_is_empty(input)) {
-        if (check_next_token(input, KEY, "def")) {
+    while (!stream_is_empty(input)) {
+        if (check_next_token(input, TK_DEF)) {
             NodeList_add(funcs, parse_funcdecl(input));
         } else {
             NodeList_add(vars, parse_vardecl(input));
@@ -973,6 +1150,27 @@ ASTNode* parse (TokenQueue* input)
         Error_throw_printf("Null Input\n");
     }
 
-    return parse_program(input);
+    TokenStream stream = { .queue = input };
+    ASTNode* tree = parse_program(&stream);
+    stream_close(&stream);
+    return tree;
+}
+
+/**
+ * @brief Parse function (tokens scanned on demand)
+ * 
+ * @param input 
+ * @return ASTNode* 
+ */
+ASTNode* parse_stream (Lexer* input)
+{
+    if (input == NULL) {
+        Error_throw_printf("Null Input\n");
+    }
+
+    TokenStream stream = { .lexer = input };
+    ASTNode* tree = parse_program(&stream);
+    stream_close(&stream);
+    return tree;
 }
 
@@ -0,0 +1,208 @@
+/**
+ * @file scan.c
+ * @brief Byte-scanning kernels used by the lexer
+ */
+#include "scan.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/*
+ * Scalar kernels
+ */
+
+/**
+ * @brief Check whether a character is skipped by @ref scan_skip_blanks
+ */
+bool is_blank (char c)
+{
+    return c == ' ' || c == '\t' || c == '\n';
+}
+
+const char* skip_blanks_scalar (const char* p, const char* end, int* newlines, const char** line_start)
+{
+    while (p < end && is_blank(*p)) {
+        if (*p == '\n') {
+            (*newlines)++;
+            *line_start = p + 1;
+        }
+        p++;
+    }
+    return p;
+}
+
+const char* find_scalar (const char* p, const char* end, char c)
+{
+    const char* found = (const char*)memchr(p, c, end - p);
+    return found != NULL ? found : end;
+}
+
+#ifdef HAVE_X86_SIMD
+
+/**
+ * @brief Account for the newlines in a block of blanks
+ *
+ * @param block Start of block
+ * @param newline_mask Bit i is set if block[i] is a newline (already limited
+ * to the skipped characters)
+ */
+void count_newlines (const char* block, uint32_t newline_mask, int* newlines, const char** line_start)
+{
+    if (newline_mask != 0) {
+        *newlines += __builtin_popcount(newline_mask);
+        *line_start = block + (31 - __builtin_clz(newline_mask)) + 1;
+    }
+}
+
+/*
+ * SSE2 kernels (16 bytes at a time; always available on x86-64)
+ */
+
+const char* skip_blanks_sse2 (const char* p, const char* end, int* newlines, const char** line_start)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i newline = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        __m128i nl = _mm_cmpeq_epi8(chunk, newline);
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                                  _mm_cmpeq_epi8(chunk, tab)), nl);
+        uint32_t blank_mask = (uint32_t)_mm_movemask_epi8(blank);
+        uint32_t nl_mask = (uint32_t)_mm_movemask_epi8(nl);
+        if (blank_mask != 0xFFFF) {
+            int skipped = __builtin_ctz(~blank_mask);
+            count_newlines(p, nl_mask & ((1u << skipped) - 1), newlines, line_start);
+            return p + skipped;
+        }
+        count_newlines(p, nl_mask, newlines, line_start);
+        p += 16;
+    }
+    return skip_blanks_scalar(p, end, newlines, line_start);
+}
+
+const char* find_sse2 (const char* p, const char* end, char c)
+{
+    const __m128i target = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, target));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    return find_scalar(p, end, c);
+}
+
+/*
+ * AVX2 kernels (32 bytes at a time; only used if cpuid reports AVX2)
+ */
+
+__attribute__((target("avx2")))
+const char* skip_blanks_avx2 (const char* p, const char* end, int* newlines, const char** line_start)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        __m256i nl = _mm256_cmpeq_epi8(chunk, newline);
+        __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),
+                                                        _mm256_cmpeq_epi8(chunk, tab)), nl);
+        uint32_t blank_mask = (uint32_t)_mm256_movemask_epi8(blank);
+        uint32_t nl_mask = (uint32_t)_mm256_movemask_epi8(nl);
+        if (blank_mask != 0xFFFFFFFF) {
+            int skipped = __builtin_ctz(~blank_mask);
+            count_newlines(p, nl_mask & ((1u << skipped) - 1), newlines, line_start);
+            return p + skipped;
+        }
+        count_newlines(p, nl_mask, newlines, line_start);
+        p += 32;
+    }
+    return skip_blanks_sse2(p, end, newlines, line_start);
+}
+
+__attribute__((target("avx2")))
+const char* find_avx2 (const char* p, const char* end, char c)
+{
+    const __m256i target = _mm256_set1_epi8(c);
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, target));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return find_sse2(p, end, c);
+}
+
+#endif
+
+/*
+ * Run-time dispatch
+ */
+
+/**
+ * @brief Currently-selected blank-skipping kernel (@c NULL until selected)
+ */
+const char* (*skip_blanks_impl) (const char*, const char*, int*, const char**) = NULL;
+
+/**
+ * @brief Currently-selected character-finding kernel (@c NULL until selected)
+ */
+const char* (*find_impl) (const char*, const char*, char) = NULL;
+
+ScanImpl scan_select (ScanImpl impl)
+{
+#ifdef HAVE_X86_SIMD
+    if (impl == SCAN_AUTO || impl == SCAN_AVX2) {
+        impl = (__builtin_cpu_supports("avx2") ? SCAN_AVX2 : SCAN_SSE2);
+    }
+#else
+    impl = SCAN_SCALAR;
+#endif
+    switch (impl) {
+#ifdef HAVE_X86_SIMD
+        case SCAN_AVX2:
+            skip_blanks_impl = skip_blanks_avx2;
+            find_impl = find_avx2;
+            break;
+        case SCAN_SSE2:
+            skip_blanks_impl = skip_blanks_sse2;
+            find_impl = find_sse2;
+            break;
+#endif
+        default:
+            skip_blanks_impl = skip_blanks_scalar;
+            find_impl = find_scalar;
+            break;
+    }
+    return impl;
+}
+
+void scan_init (void)
+{
+    if (skip_blanks_impl == NULL || find_impl == NULL) {
+        scan_select(SCAN_AUTO);
+    }
+}
+
+const char* scan_skip_blanks (const char* p, const char* end, int* newlines, const char** line_start)
+{
+    if (skip_blanks_impl == NULL) {
+        scan_select(SCAN_AUTO);
+    }
+    return skip_blanks_impl(p, end, newlines, line_start);
+}
+
+const char* scan_find (const char* p, const char* end, char c)
+{
+    if (find_impl == NULL) {
+        scan_select(SCAN_AUTO);
+    }
+    return find_impl(p, end, c);
+}
@@ -0,0 +1,310 @@
+/**
+ * @file scanner.c
+ * @brief Single-pass scanner and pull-based lexer
+ */
+#include "scanner.h"
+#include "scan.h"
+
+/**
+ * @brief Check whether a character is an ASCII letter
+ */
+bool is_letter (char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/**
+ * @brief Check whether a character is a decimal digit
+ */
+bool is_digit (char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * @brief Check whether a character is a hexadecimal digit
+ */
+bool is_hex_digit (char c)
+{
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/**
+ * @brief Length of the symbol at the start of the text (or 0 if there is none)
+ *
+ * @param c First character
+ * @param next Character after @p c (or @c '\\0' at the end of the input)
+ * @param dialect Token rules to follow
+ */
+size_t symbol_length (char c, char next, LexDialect dialect)
+{
+    if (dialect == LEX_DECAF) {
+        switch (c) {
+            case '!': case '<': case '>': case '=':
+                return next == '=' ? 2 : 1;
+            case '&': case '|':
+                return next == c ? 2 : 0;
+            case '-': case '%': case '*': case '+': case '(': case ')': case '/':
+            case '[': case ']': case '{': case '}': case ';': case ',':
+                return 1;
+            default:
+                return 0;
+        }
+    }
+    switch (c) {
+        case '!': case '<': case '>':
+            return next == '=' ? 2 : 0;
+        case '=':
+            return next == '=' ? 2 : 1;
+        case '-': case '%': case '*': case '+': case '(': case ')':
+        case '[': case ']': case '{': case '}': case ';': case '\\':
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Find the closing quote of a string literal that follows the
+ * @ref LEX_DECAF rules
+ *
+ * @param p First character after the opening quote
+ * @param end End of input
+ * @returns Closing quote (or @p end if the text is not a string literal)
+ */
+const char* find_decaf_string_end (const char* p, const char* end)
+{
+    while (p < end) {
+        switch (*p) {
+            case '"':
+                return p;
+            case '\n': case '\r':
+                return end;
+            case '\\':
+                if (p + 1 == end || (p[1] != 'n' && p[1] != 't' && p[1] != '"' && p[1] != '\\')) {
+                    return end;
+                }
+                p += 2;
+                break;
+            default:
+                p++;
+        }
+    }
+    return end;
+}
+
+void Scanner_init (Scanner* scanner, const char* text, size_t length)
+{
+    scanner->text = text;
+    scanner->length = length;
+    scanner->pos = 0;
+    scanner->line = 1;
+    scanner->line_start = 0;
+    scanner->error = LEX_OK;
+    scanner->dialect = LEX_PROJECT1;
+}
+
+/**
+ * @brief Character at a position in the input (or @c '\\0' past the end)
+ */
+#define AT(P) ((P) < end ? *(P) : '\0')
+
+bool Scanner_try_next (Scanner* scanner, TokenSpan* span)
+{
+    const char* text = scanner->text;
+    const char* end = text + scanner->length;
+    const char* p = text + scanner->pos;
+    while (p < end) {
+        const char* start = p;
+        TokenType type;
+        size_t len;
+        const char* close;
+
+        /* each case consumes one token (or run of skipped text) */
+        if (*p == ' ' || *p == '\t' || *p == '\n') {
+            // skip whitespace and count new lines
+            int newlines = 0;
+            const char* line_start = text + scanner->line_start;
+            p = scan_skip_blanks(p, end, &newlines, &line_start);
+            scanner->line += newlines;
+            scanner->line_start = line_start - text;
+            continue;
+        } else if (*p == '\r' && scanner->dialect == LEX_DECAF) {
+            // skip carriage returns
+            p++;
+            continue;
+        } else if (p[0] == '0' && AT(p+1) == 'x' && is_hex_digit(AT(p+2))) {
+            // finding a hex literal (with LEX_DECAF, a leading zero digit is
+            // a literal by itself)
+            p += 2;
+            if (*p == '0' && scanner->dialect == LEX_DECAF) {
+                p++;
+            } else {
+                while (is_hex_digit(AT(p))) {
+                    p++;
+                }
+            }
+            type = HEXLIT;
+        } else if (*p == '"' && (close = (scanner->dialect == LEX_DECAF
+                        ? find_decaf_string_end(p + 1, end)
+                        : scan_find(p + 1, end, '"'))) != end) {
+            // finding a string literal (may span lines unless LEX_DECAF)
+            p = close + 1;
+            type = STRLIT;
+        } else if (is_letter(*p)) {
+            // finding an identifier and comparing it to the keywords and reserved words
+            while (is_letter(AT(p)) || is_digit(AT(p)) || AT(p) == '_') {
+                p++;
+            }
+            Keyword kw = Keyword_classify(start, p - start);
+            if (kw == RESERVED_WORD) {
+                scanner->error = LEX_RESERVED_WORD;
+                scanner->pos = start - text;
+                return false;
+            }
+            type = (kw == NOT_KEYWORD ? ID : KEY);
+        } else if (p[0] == '/' && AT(p+1) == '/') {
+            // skip comments
+            p = scan_find(p, end, '\n');
+            continue;
+        } else if ((len = symbol_length(p[0], AT(p+1), scanner->dialect)) > 0) {
+            // finding a symbol
+            p += len;
+            type = SYM;
+        } else if (is_digit(*p)) {
+            // finding a decimal literal (a leading zero is a literal by itself)
+            p++;
+            while (start[0] != '0' && is_digit(AT(p))) {
+                p++;
+            }
+            type = DECLIT;
+        } else {
+            scanner->error = LEX_INVALID_TOKEN;
+            scanner->pos = start - text;
+            return false;
+        }
+
+        span->type = type;
+        span->kind = TokenKind_classify(type, start, p - start);
+        span->offset = start - text;
+        span->length = p - start;
+        span->line = scanner->line;
+        span->column = (int)(span->offset - scanner->line_start) + 1;
+        scanner->pos = p - text;
+        return true;
+    }
+    scanner->pos = p - text;
+    return false;
+}
+
+void Scanner_throw_error (Scanner* scanner)
+{
+    if (scanner->dialect == LEX_DECAF && scanner->error != LEX_OK) {
+        /* quote the word or (up to the next space or line break) the text */
+        const char* start = scanner->text + scanner->pos;
+        const char* end = scanner->text + scanner->length;
+        const char* p = start;
+        while (p < end && p - start < MAX_TOKEN_LEN - 1 && (scanner->error == LEX_RESERVED_WORD
+                    ? (is_letter(*p) || is_digit(*p) || *p == '_')
+                    : (*p != ' ' && *p != '\n' && *p != '\r' && *p != '\0'))) {
+            p++;
+        }
+        if (scanner->error == LEX_RESERVED_WORD) {
+            Error_throw_printf("Reserved word: \"%.*s\"\n", (int)(p - start), start);
+        }
+        Error_throw_printf("Invalid token on line %d: \"%.*s\"\n", scanner->line, (int)(p - start), start);
+    }
+    switch (scanner->error) {
+        case LEX_INVALID_TOKEN:
+            Error_throw_printf("Invalid token at line %d", scanner->line, scanner->line);
+            break;
+        case LEX_RESERVED_WORD:
+            Error_throw_printf("Resvered Word found at line %d", scanner->line, scanner->line);
+            break;
+        default:
+            break;
+    }
+}
+
+bool Scanner_next (Scanner* scanner, TokenSpan* span)
+{
+    if (Scanner_try_next(scanner, span)) {
+        return true;
+    }
+    Scanner_throw_error(scanner);
+    return false;
+}
+
+Lexer* Lexer_new (const char* text, size_t length, LexDialect dialect)
+{
+    Lexer* lexer = (Lexer*)calloc(1, sizeof(Lexer));
+    CHECK_MALLOC_PTR(lexer)
+    Scanner_init(&lexer->scanner, text, length);
+    lexer->scanner.dialect = dialect;
+    lexer->first = 0;
+    lexer->count = 0;
+    return lexer;
+}
+
+const TokenSpan* Lexer_peek_span (Lexer* lexer, size_t k)
+{
+    if (k >= LEXER_LOOKAHEAD) {
+        Error_throw_printf("Lookahead of %zu tokens is not supported", k);
+    }
+
+    /* scan until the window holds k+1 tokens (or the input ends) */
+    while (lexer->count <= k &&
+           Scanner_next(&lexer->scanner, &lexer->window[(lexer->first + lexer->count) % LEXER_LOOKAHEAD])) {
+        lexer->count++;
+    }
+    if (k >= lexer->count) {
+        return NULL;
+    }
+    return &lexer->window[(lexer->first + k) % LEXER_LOOKAHEAD];
+}
+
+bool Lexer_next_span (Lexer* lexer, TokenSpan* span)
+{
+    const TokenSpan* next = Lexer_peek_span(lexer, 0);
+    if (next == NULL) {
+        return false;
+    }
+    *span = *next;
+    lexer->first = (lexer->first + 1) % LEXER_LOOKAHEAD;
+    lexer->count--;
+    return true;
+}
+
+/**
+ * @brief Copy a token span into the lexer's token buffer
+ *
+ * @returns Token buffer
+ */
+Token* Lexer_materialize (Lexer* lexer, const TokenSpan* span)
+{
+    Token* token = &lexer->token;
+    token->type = span->type;
+    TokenSpan_text(lexer->scanner.text, span, token->text);
+    token->line = span->line;
+    token->next = NULL;
+    token->in_arena = true;
+    token->kind = span->kind;
+    return token;
+}
+
+Token* Lexer_peek (Lexer* lexer, size_t k)
+{
+    const TokenSpan* span = Lexer_peek_span(lexer, k);
+    return (span == NULL ? NULL : Lexer_materialize(lexer, span));
+}
+
+Token* Lexer_next (Lexer* lexer)
+{
+    TokenSpan span;
+    return (Lexer_next_span(lexer, &span) ? Lexer_materialize(lexer, &span) : NULL);
+}
+
+void Lexer_free (Lexer* lexer)
+{
+    free(lexer);
+}
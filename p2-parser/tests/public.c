@@ -80,6 +80,47 @@ TEST_INT_LITERAL(C_hexlit, "0x10", 16)
 TEST_STR_LITERAL(C_strlit, "\"abc\"", "abc")
 TEST_STR_LITERAL(A_newline, "\"ab\\nc\"", "ab\nc")
 
+/*
+ * Test that precedence climbing builds the same trees as recursive descent.
+ */
+
+TEST_SAME_TREE_EXPR(B_same_tree_left_assoc, "1 - 2 - 3 * 4 / 5 % 6")
+TEST_SAME_TREE_EXPR(B_same_tree_levels, "a - b + c < d <= e >= f > g == h != i && j || k")
+TEST_SAME_TREE_EXPR(B_same_tree_reversed, "k || j && i != h == g > f >= e <= d < c + b - a % 2 / 3 * 4")
+TEST_SAME_TREE_EXPR(B_same_tree_unary, "-x * !y + (z - -1) * foo(a + b, c[d * 2])")
+TEST_SAME_TREE_EXPR(B_same_tree_lines, "a\n*\nb\n%\nc\n+\nd\n-\ne")
+TEST_SAME_TREE_EXPR(B_same_tree_invalid, "3 + * 4")
+
+TEST_SAME_TREE_ARENA(B_arena_expr, "def int main () { return -x * (y + 1) - f(a, b[2]) ; }")
+TEST_SAME_TREE_ARENA(B_arena_program, "int g[10]; bool b;\n"
+        "def int f(int x, bool y) { int z; if (y) { z = x; } else { z = 0; } return z; }\n"
+        "def void main() { while (b) { f(g[0], true); break; } }")
+TEST_SAME_TREE_ARENA(B_arena_invalid, "def int main () { return 3 + * 4 ; }")
+
+TEST_SAME_TREE_STREAM(B_stream_program, "int g[10]; bool b;\n"
+        "def int f(int x, bool y) { int z; if (y) { z = x; } else { z = 0; } return z; }\n"
+        "def void main() { while (b) { g[1+2*3] = f(g[0] - 0x1F, !b && true); continue; }\n"
+        "    print_str(\"a\\tb\\n\"); return; }")
+TEST_SAME_TREE_STREAM(B_stream_lines, "def int main ()\n{\n  int\n  x;\n  x\n  =\n  -\n  1;\n  return\n  x\n  ;\n}\n")
+TEST_SAME_TREE_STREAM(B_stream_literals, "def void main ()\r\n{\r\n"
+        "    print(\"a\\\"b\\\\\", 0x1f, 0x0, 012, true); // comment\r\n}\r\n")
+TEST_SAME_TREE_STREAM(B_stream_invalid, "def int main () { return 3 + * 4 ; }")
+TEST_SAME_TREE_STREAM(B_stream_invalid_end, "def int main () { return 0 ;")
+TEST_SAME_TREE_STREAM(B_stream_lex_error, "def int main () { int $x; return 0 ; }")
+
+TEST_SAME_TRAVERSAL(B_traversal_order,
+        "int g[10]; bool b;\n"
+        "def int f(int x, bool y) { int z; if (y) { z = x; } else { z = 0; } return z; }\n"
+        "def void main() { while (b) { g[1+2*3] = f(g[0] - 4, !b && true); continue; } return; }")
+
+START_TEST (A_deep_expr)
+{ ck_assert (deep_expr(100000)); }
+END_TEST
+
+START_TEST (A_deep_loops)
+{ ck_assert (deep_loops(100000)); }
+END_TEST
+
 #endif
 
 /**
@@ -121,9 +162,27 @@ void public_tests (Suite *s)
     TEST(B_add_expr_bool);
     TEST(B_neg_expr);
     TEST(B_invalid_add);
+    TEST(B_same_tree_left_assoc);
+    TEST(B_same_tree_levels);
+    TEST(B_same_tree_reversed);
+    TEST(B_same_tree_unary);
+    TEST(B_same_tree_lines);
+    TEST(B_same_tree_invalid);
+    TEST(B_arena_expr);
+    TEST(B_arena_program);
+    TEST(B_arena_invalid);
+    TEST(B_stream_program);
+    TEST(B_stream_lines);
+    TEST(B_stream_literals);
+    TEST(B_stream_invalid);
+    TEST(B_stream_invalid_end);
+    TEST(B_stream_lex_error);
+    TEST(B_traversal_order);
 
     TEST(A_arrays);
     TEST(A_newline);
+    TEST(A_deep_expr);
+    TEST(A_deep_loops);
 
     suite_add_tcase (s, tc);
 }
@@ -18,6 +18,18 @@ ASTNode* run_parser (char* text)
     }
 }
 
+ASTNode* run_stream_parser (char* text)
+{
+    Lexer* lexer = Lexer_new(text, strlen(text), LEX_DECAF);
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        /* no error */
+        tree = parse_stream(lexer);
+    }
+    Lexer_free(lexer);
+    return tree;
+}
+
 bool valid_program (char* text)
 {
     return run_parser(text) != NULL;
@@ -28,6 +40,212 @@ bool invalid_program (char* text)
     return run_parser(text) == NULL;
 }
 
+/**
+ * @brief Read the contents of a temporary file and close it
+ *
+ * @returns File contents (caller must free)
+ */
+char* read_and_close (FILE* out)
+{
+    long size = ftell(out);
+    char* printed = (char*)calloc(size + 1, 1);
+    rewind(out);
+    if (fread(printed, 1, size, out) != (size_t)size) {
+        printed[0] = '\0';
+    }
+    fclose(out);
+    return printed;
+}
+
+/**
+ * @brief Parse given text with an expression parser and print the tree
+ *
+ * @param use_arena Allocate the tree in an arena (see @ref ASTArena)
+ * @param streamed Parse with @ref parse_stream instead of @ref parse
+ * @returns Printed tree (caller must free) or @c NULL if there was an error
+ */
+char* print_tree (char* text, ExprParser impl, bool use_arena, bool streamed)
+{
+    ASTArena* arena = (use_arena ? ASTArena_new() : NULL);
+    ASTArena_use(arena);
+    parse_select_expr(impl);
+    ASTNode* tree = (streamed ? run_stream_parser(text) : run_parser(text));
+    parse_select_expr(EXPR_PRECEDENCE);
+    if (tree == NULL) {
+        ASTArena_free(arena);
+        return NULL;
+    }
+    FILE* out = tmpfile();
+    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(PrintVisitor_new(out), tree);
+    ASTNode_free(tree);
+    ASTArena_free(arena);
+    return read_and_close(out);
+}
+
+bool same_tree (char* text)
+{
+    char* descent = print_tree(text, EXPR_DESCENT, false, false);
+    char* climbing = print_tree(text, EXPR_PRECEDENCE, false, false);
+    bool same = (descent == NULL || climbing == NULL) ? (descent == climbing)
+                                                       : (strcmp(descent, climbing) == 0);
+    free(descent);
+    free(climbing);
+    return same;
+}
+
+bool same_tree_in_arena (char* text)
+{
+    char* expected = print_tree(text, EXPR_PRECEDENCE, false, false);
+    char* printed = print_tree(text, EXPR_PRECEDENCE, true, false);
+    bool same = (expected == NULL || printed == NULL) ? (expected == printed)
+                                                      : (strcmp(expected, printed) == 0);
+    free(expected);
+    free(printed);
+    return same;
+}
+
+bool same_tree_streamed (char* text)
+{
+    char* expected = print_tree(text, EXPR_PRECEDENCE, false, false);
+    char* streamed = print_tree(text, EXPR_PRECEDENCE, false, true);
+    bool same = (expected == NULL || streamed == NULL) ? (expected == streamed)
+                                                       : (strcmp(expected, streamed) == 0);
+    free(expected);
+    free(streamed);
+    return same;
+}
+
+/**
+ * @brief Log a pre-visit
+ */
+void TraceVisitor_previsit (NodeVisitor* visitor, ASTNode* node)
+{
+    fprintf((FILE*)visitor->data, "pre %s %d\n", NodeType_to_string(node->type), node->source_line);
+}
+
+/**
+ * @brief Log an in-visit
+ */
+void TraceVisitor_invisit (NodeVisitor* visitor, ASTNode* node)
+{
+    fprintf((FILE*)visitor->data, "in %s %d\n", NodeType_to_string(node->type), node->source_line);
+}
+
+/**
+ * @brief Log a post-visit
+ */
+void TraceVisitor_postvisit (NodeVisitor* visitor, ASTNode* node)
+{
+    fprintf((FILE*)visitor->data, "post %s %d\n", NodeType_to_string(node->type), node->source_line);
+}
+
+/**
+ * @brief Parse given text and log every visitor routine invoked by a traversal
+ *
+ * @returns Log (caller must free) or @c NULL if there was an error
+ */
+char* trace_traversal (char* text, TraversalImpl impl)
+{
+    ASTNode* tree = run_parser(text);
+    if (tree == NULL) {
+        return NULL;
+    }
+    FILE* out = tmpfile();
+    NodeVisitor* v = NodeVisitor_new();
+    v->data              = (void*)out;
+    v->previsit_default  = TraceVisitor_previsit;
+    v->invisit_binaryop  = TraceVisitor_invisit;
+    v->postvisit_default = TraceVisitor_postvisit;
+    NodeVisitor_select_traversal(impl);
+    NodeVisitor_traverse_and_free(v, tree);
+    NodeVisitor_select_traversal(TRAVERSE_ITERATIVE);
+    ASTNode_free(tree);
+    return read_and_close(out);
+}
+
+bool same_traversal (char* text)
+{
+    char* recursive = trace_traversal(text, TRAVERSE_RECURSIVE);
+    char* iterative = trace_traversal(text, TRAVERSE_ITERATIVE);
+    bool same = (recursive == NULL || iterative == NULL) ? (recursive == iterative)
+                                                         : (strcmp(recursive, iterative) == 0);
+    free(recursive);
+    free(iterative);
+    return same;
+}
+
+/**
+ * @brief Set up parent links and depths (in one traversal) and check the depth
+ * of a node
+ */
+bool check_depth (ASTNode* tree, ASTNode* node, long expected_depth)
+{
+    NodeVisitor_traverse_and_free(FusedVisitor_new(2,
+            SetParentVisitor_new(), CalcDepthVisitor_new()), tree);
+    return (long)ASTNode_get_slot(node, SLOT_DEPTH) == expected_depth;
+}
+
+bool deep_expr (int terms)
+{
+    /* def int main () { return 1+1+...+1 ; } (tokens are built directly
+     * because the precompiled lexer is very slow on long inputs) */
+    TokenQueue* tokens = TokenQueue_new();
+    TokenQueue_add(tokens, Token_new(KEY, "def", 1));
+    TokenQueue_add(tokens, Token_new(KEY, "int", 1));
+    TokenQueue_add(tokens, Token_new(ID,  "main", 1));
+    TokenQueue_add(tokens, Token_new(SYM, "(", 1));
+    TokenQueue_add(tokens, Token_new(SYM, ")", 1));
+    TokenQueue_add(tokens, Token_new(SYM, "{", 1));
+    TokenQueue_add(tokens, Token_new(KEY, "return", 1));
+    TokenQueue_add(tokens, Token_new(DECLIT, "1", 1));
+    for (int i = 1; i < terms; i++) {
+        TokenQueue_add(tokens, Token_new(SYM, "+", 1));
+        TokenQueue_add(tokens, Token_new(DECLIT, "1", 1));
+    }
+    TokenQueue_add(tokens, Token_new(SYM, ";", 1));
+    TokenQueue_add(tokens, Token_new(SYM, "}", 1));
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        tree = parse(tokens);
+    }
+    TokenQueue_free(tokens);
+    if (tree == NULL) {
+        return false;
+    }
+
+    /* program -> funcdecl -> block -> return -> (terms-1) operators -> literal */
+    ASTNode* leaf = tree->program.functions->head->funcdecl.body->block.statements->head->funcreturn.value;
+    while (leaf->type == BINARYOP) {
+        leaf = leaf->binaryop.left;
+    }
+    bool valid = check_depth(tree, leaf, 3 + terms);
+    ASTNode_free(tree);
+    return valid;
+}
+
+bool deep_loops (int depth)
+{
+    /* def int main () { while (true) { while (true) { ... { } } } } (built
+     * directly because the parser handles nesting recursively) */
+    ASTNode* innermost = BlockNode_new(NodeList_new(), NodeList_new(), depth + 1);
+    ASTNode* block = innermost;
+    for (int i = depth; i > 0; i--) {
+        NodeList* stmts = NodeList_new();
+        NodeList_add(stmts, WhileLoopNode_new(LiteralNode_new_bool(true, i), block, i));
+        block = BlockNode_new(NodeList_new(), stmts, i);
+    }
+    NodeList* funcs = NodeList_new();
+    NodeList_add(funcs, FuncDeclNode_new("main", INT, ParameterList_new(), block, 1));
+    ASTNode* tree = ProgramNode_new(NodeList_new(), funcs);
+
+    /* program -> funcdecl -> depth * (block -> whileloop) -> block */
+    bool valid = check_depth(tree, innermost, 2 + 2 * depth);
+    ASTNode_free(tree);
+    return valid;
+}
+
 extern void public_tests (Suite *s);
 extern void private_tests (Suite *s);
 
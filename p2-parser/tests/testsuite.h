@@ -75,6 +75,38 @@ END_TEST
   ck_assert_str_eq(value, VALUE); } \
 END_TEST
 
+/**
+ * @brief Define a test case that checks that both expression parsers produce
+ * the same tree for a main function returning an expression
+ */
+#define TEST_SAME_TREE_EXPR(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_tree("def int main () { return " TEXT " ; }")); } \
+END_TEST
+
+/**
+ * @brief Define a test case that checks that a program parses to the same tree
+ * with and without an AST arena
+ */
+#define TEST_SAME_TREE_ARENA(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_tree_in_arena(TEXT)); } \
+END_TEST
+
+/**
+ * @brief Define a test case that checks that a program parses to the same tree
+ * from a token queue and from a lexer (see @ref parse_stream)
+ */
+#define TEST_SAME_TREE_STREAM(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_tree_streamed(TEXT)); } \
+END_TEST
+
+/**
+ * @brief Define a test case that checks that the iterative and recursive
+ * traversals invoke the same visitor routines in the same order
+ */
+#define TEST_SAME_TRAVERSAL(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_traversal(TEXT)); } \
+END_TEST
+
 /**
  * @brief Add a test to the test suite
  */
@@ -91,6 +123,15 @@ END_TEST
  */
 ASTNode* run_parser (char* text);
 
+/**
+ * @brief Run the parser on given text, scanning tokens on demand (see
+ * @ref parse_stream)
+ *
+ * @param text Code to parse
+ * @returns AST or @c NULL if there was an error
+ */
+ASTNode* run_stream_parser (char* text);
+
 /**
  * @brief Run lexer and parser on given text and verify that it throws an exception.
  *
@@ -107,3 +148,63 @@ bool invalid_program (char* text);
  * @returns True if and only if the text was lexed and parsed successfully
  */
 bool valid_program (char* text);
+
+/**
+ * @brief Parse given text with both expression parsers and verify that the
+ * printed trees (including line numbers) are identical.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if both parsers failed or both produced the same
+ * tree
+ */
+bool same_tree (char* text);
+
+/**
+ * @brief Parse given text with and without an AST arena and verify that the
+ * printed trees are identical.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if both parses failed or both produced the same
+ * tree
+ */
+bool same_tree_in_arena (char* text);
+
+/**
+ * @brief Parse given text from a token queue (lexed in advance) and from a
+ * lexer (scanned on demand) and verify that the printed trees are identical.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if both parses failed or both produced the same
+ * tree
+ */
+bool same_tree_streamed (char* text);
+
+/**
+ * @brief Parse given text and verify that the iterative and recursive
+ * traversals invoke the same visitor routines (pre-, in- and post-visits) on
+ * the same nodes in the same order.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if parsing failed or both traversals matched
+ */
+bool same_traversal (char* text);
+
+/**
+ * @brief Parse a main function that returns a sum of the given number of
+ * terms (one very deep tree of binary operators), then set up, check and free
+ * the tree.
+ *
+ * @param terms Number of terms in the sum
+ * @returns True if and only if the program parsed and the deepest node has the
+ * right depth
+ */
+bool deep_expr (int terms);
+
+/**
+ * @brief Build a main function with the given number of nested while loops,
+ * then set up, check and free the tree.
+ *
+ * @param depth Number of nested loops
+ * @returns True if and only if the innermost block has the right depth
+ */
+bool deep_loops (int depth);
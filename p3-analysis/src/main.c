@@ -35,31 +35,6 @@ void Error_throw_printf (const char* format, ...)
     longjmp(decaf_error, 1);
 }
 
-/**
- * @brief Read all text data from a file
- *
- * @param filename Name of file to read
- * @param text String buffer destination (must be #MAX_FILE_SIZE characters long)
- * @returns True if and only if the file read was successful.
- */
-bool read_file (const char* filename, char* text)
-{
-    FILE* input = fopen(filename, "r");
-    if (input == NULL) {
-        return false;
-    }
-    size_t nchars = 0;
-    char* p = text;
-    int c;
-    while (nchars < MAX_FILE_SIZE && (c = fgetc(input)) != EOF) {
-        *p++ = (char)c;
-        nchars++;
-    }
-    *p = '\0';
-    fclose(input);
-    return true;
-}
-
 /**
  * @brief Compiler entry point
  *
@@ -78,12 +53,17 @@ int main(int argc, char** argv)
     char* filename = argv[argc-1];
 
     /* read file */
-    char text[MAX_FILE_SIZE];
-    if (!read_file(filename, text)) {
+    SourceText* source = SourceText_read(filename);
+    if (source == NULL) {
         fprintf(stderr, "Could not read file: %s", filename);
         exit(EXIT_FAILURE);
     }
 
+    /* allocate the AST in an arena (set DECAF_NO_ARENA in the environment to
+     * allocate each object individually, e.g., for valgrind) */
+    ASTArena* arena = (getenv("DECAF_NO_ARENA") == NULL ? ASTArena_new() : NULL);
+    ASTArena_use(arena);
+
     /* FRONT END */
 
     TokenQueue* tokens = NULL;
@@ -93,7 +73,11 @@ int main(int argc, char** argv)
     if (setjmp(decaf_error) == 0) {
 
         /* PROJECT 1: lexer */
-        tokens = lex(text);
+        tokens = lex(source->text);
+
+        /* clean up source text (tokens hold copies of their text) */
+        SourceText_free(source);
+        source = NULL;
 
         /* PROJECT 2: parser */
         tree = parse(tokens);
@@ -102,8 +86,11 @@ int main(int argc, char** argv)
 
         /* handle fatal error: print message and clean up */
         fprintf(stderr, "%s", decaf_error_msg);
+        if (source   != NULL) SourceText_free(source);
         if (tokens   != NULL) TokenQueue_free(tokens);
         if (tree     != NULL) ASTNode_free(tree);
+        ASTArena_free(arena);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
@@ -111,14 +98,12 @@ int main(int argc, char** argv)
     TokenQueue_free(tokens);
     tokens = NULL;
 
-    /* set up parent links and calculate node depths */
-    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
-    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
-
-    /* MIDDLE END */
-
-    /* build symbol tables */
-    NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    /* set up parent links, calculate node depths, and (MIDDLE END) build
+     * symbol tables and bind each name to its symbol, all in a single
+     * traversal */
+    NodeVisitor_traverse_and_free(FusedVisitor_new(4,
+            SetParentVisitor_new(), CalcDepthVisitor_new(),
+            BuildSymbolTablesVisitor_new(), ResolveSymbolsVisitor_new()), tree);
 
     /* PROJECT 3: analysis */
     ErrorList* errors = analyze(tree);
@@ -145,8 +130,10 @@ int main(int argc, char** argv)
 
     /* clean up */
     ASTNode_free(tree);
+    ASTArena_free(arena);
     ErrorList_free(errors);
     errors = NULL;
+    free_interned_strings();
 
     return EXIT_SUCCESS;
 }
@@ -126,7 +126,7 @@ Symbol* lookup_symbol_with_reporting(NodeVisitor* visitor, ASTNode* node, const
  * @brief Macro for shorter retrieval of the inferred @c type attribute
  * in postvisit
  */
-#define GET_INFERRED_TYPE(N) (DecafType)(long)ASTNode_get_attribute(N, "type")
+#define GET_INFERRED_TYPE(N) (DecafType)(long)ASTNode_get_slot(N, SLOT_TYPE)
 
 ErrorList* analyze (ASTNode* tree)
 {
@@ -353,7 +353,7 @@ void AnalysisVisitor_postvisit_assignment(NodeVisitor* visitor, ASTNode* node) {
     DecafType lhs_type = GET_INFERRED_TYPE(node->assignment.location);
     // check if the right hand side is a funccall then make sure it exists
     if (node->assignment.value->type == FUNCCALL) {
-        Symbol* symbol = lookup_symbol(node, node->assignment.value->funccall.name);
+        Symbol* symbol = lookup_symbol(node->assignment.value, node->assignment.value->funccall.name);
         if (symbol == NULL) {
             return;
         }
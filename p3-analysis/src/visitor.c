@@ -57,17 +57,17 @@ NodeVisitor* NodeVisitor_new(void)
 #define POSTVISIT(TYPE) if (visitor->postvisit_ ## TYPE != NULL) { visitor->postvisit_ ## TYPE(visitor, node); } \
                                                            else  { visitor->postvisit_default (visitor, node); }
 
-void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
+void NodeVisitor_traverse_recursive (NodeVisitor* visitor, ASTNode* node)
 {
     switch (node->type)
     {
         case PROGRAM:
             PREVISIT(program)
             FOR_EACH(ASTNode*, var, node->program.variables) {
-                NodeVisitor_traverse(visitor, var);
+                NodeVisitor_traverse_recursive(visitor, var);
             }
             FOR_EACH(ASTNode*, func, node->program.functions) {
-                NodeVisitor_traverse(visitor, func);
+                NodeVisitor_traverse_recursive(visitor, func);
             }
             POSTVISIT(program)
             break;
@@ -79,49 +79,49 @@ void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
 
         case FUNCDECL:
             PREVISIT(funcdecl)
-            NodeVisitor_traverse(visitor, node->funcdecl.body);
+            NodeVisitor_traverse_recursive(visitor, node->funcdecl.body);
             POSTVISIT(funcdecl)
             break;
 
         case BLOCK:
             PREVISIT(block)
             FOR_EACH (ASTNode*, var, node->block.variables) {
-                NodeVisitor_traverse(visitor, var);
+                NodeVisitor_traverse_recursive(visitor, var);
             }
             FOR_EACH (ASTNode*, stmt, node->block.statements) {
-                NodeVisitor_traverse(visitor, stmt);
+                NodeVisitor_traverse_recursive(visitor, stmt);
             }
             POSTVISIT(block)
             break;
 
         case ASSIGNMENT:
             PREVISIT(assignment)
-            NodeVisitor_traverse(visitor, node->assignment.location);
-            NodeVisitor_traverse(visitor, node->assignment.value);
+            NodeVisitor_traverse_recursive(visitor, node->assignment.location);
+            NodeVisitor_traverse_recursive(visitor, node->assignment.value);
             POSTVISIT(assignment)
             break;
 
         case CONDITIONAL:
             PREVISIT(conditional)
-            NodeVisitor_traverse(visitor, node->conditional.condition);
-            NodeVisitor_traverse(visitor, node->conditional.if_block);
+            NodeVisitor_traverse_recursive(visitor, node->conditional.condition);
+            NodeVisitor_traverse_recursive(visitor, node->conditional.if_block);
             if (node->conditional.else_block != NULL) {
-                NodeVisitor_traverse(visitor, node->conditional.else_block);
+                NodeVisitor_traverse_recursive(visitor, node->conditional.else_block);
             }
             POSTVISIT(conditional)
             break;
 
         case WHILELOOP:
             PREVISIT(whileloop)
-            NodeVisitor_traverse(visitor, node->whileloop.condition);
-            NodeVisitor_traverse(visitor, node->whileloop.body);
+            NodeVisitor_traverse_recursive(visitor, node->whileloop.condition);
+            NodeVisitor_traverse_recursive(visitor, node->whileloop.body);
             POSTVISIT(whileloop)
             break;
 
         case RETURNSTMT:
             PREVISIT(return)
             if (node->funcreturn.value != NULL) {
-                NodeVisitor_traverse(visitor, node->funcreturn.value);
+                NodeVisitor_traverse_recursive(visitor, node->funcreturn.value);
             }
             POSTVISIT(return)
             break;
@@ -138,24 +138,24 @@ void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
 
         case BINARYOP:
             PREVISIT(binaryop)
-            NodeVisitor_traverse(visitor, node->binaryop.left);
+            NodeVisitor_traverse_recursive(visitor, node->binaryop.left);
             if (visitor->invisit_binaryop != NULL) {
                 visitor->invisit_binaryop(visitor, node);
             }
-            NodeVisitor_traverse(visitor, node->binaryop.right);
+            NodeVisitor_traverse_recursive(visitor, node->binaryop.right);
             POSTVISIT(binaryop)
             break;
 
         case UNARYOP:
             PREVISIT(unaryop)
-            NodeVisitor_traverse(visitor, node->unaryop.child);
+            NodeVisitor_traverse_recursive(visitor, node->unaryop.child);
             POSTVISIT(unaryop)
             break;
 
         case LOCATION:
             PREVISIT(location)
             if (node->location.index != NULL) {
-                NodeVisitor_traverse(visitor, node->location.index);
+                NodeVisitor_traverse_recursive(visitor, node->location.index);
             }
             POSTVISIT(location)
             break;
@@ -163,7 +163,7 @@ void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
         case FUNCCALL:
             PREVISIT(funccall)
             FOR_EACH (ASTNode*, arg, node->funccall.arguments) {
-                NodeVisitor_traverse(visitor, arg);
+                NodeVisitor_traverse_recursive(visitor, arg);
             }
             POSTVISIT(funccall)
             break;
@@ -179,6 +179,251 @@ void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
     }
 }
 
+/**
+ * @brief Pre-visit a node (no traversal of children)
+ */
+void NodeVisitor_previsit (NodeVisitor* visitor, ASTNode* node)
+{
+    switch (node->type)
+    {
+        case PROGRAM:       PREVISIT(program)       break;
+        case VARDECL:       PREVISIT(vardecl)       break;
+        case FUNCDECL:      PREVISIT(funcdecl)      break;
+        case BLOCK:         PREVISIT(block)         break;
+        case ASSIGNMENT:    PREVISIT(assignment)    break;
+        case CONDITIONAL:   PREVISIT(conditional)   break;
+        case WHILELOOP:     PREVISIT(whileloop)     break;
+        case RETURNSTMT:    PREVISIT(return)        break;
+        case BREAKSTMT:     PREVISIT(break)         break;
+        case CONTINUESTMT:  PREVISIT(continue)      break;
+        case BINARYOP:      PREVISIT(binaryop)      break;
+        case UNARYOP:       PREVISIT(unaryop)       break;
+        case LOCATION:      PREVISIT(location)      break;
+        case FUNCCALL:      PREVISIT(funccall)      break;
+        case LITERAL:       PREVISIT(literal)       break;
+        default:
+            Error_throw_printf("ERROR: Unhandled node traversal\n");
+            break;
+    }
+}
+
+/**
+ * @brief Post-visit a node (no traversal of children)
+ */
+void NodeVisitor_postvisit (NodeVisitor* visitor, ASTNode* node)
+{
+    switch (node->type)
+    {
+        case PROGRAM:       POSTVISIT(program)      break;
+        case VARDECL:       POSTVISIT(vardecl)      break;
+        case FUNCDECL:      POSTVISIT(funcdecl)     break;
+        case BLOCK:         POSTVISIT(block)        break;
+        case ASSIGNMENT:    POSTVISIT(assignment)   break;
+        case CONDITIONAL:   POSTVISIT(conditional)  break;
+        case WHILELOOP:     POSTVISIT(whileloop)    break;
+        case RETURNSTMT:    POSTVISIT(return)       break;
+        case BREAKSTMT:     POSTVISIT(break)        break;
+        case CONTINUESTMT:  POSTVISIT(continue)     break;
+        case BINARYOP:      POSTVISIT(binaryop)     break;
+        case UNARYOP:       POSTVISIT(unaryop)      break;
+        case LOCATION:      POSTVISIT(location)     break;
+        case FUNCCALL:      POSTVISIT(funccall)     break;
+        case LITERAL:       POSTVISIT(literal)      break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Pending node in an iterative traversal
+ */
+typedef struct TraversalFrame
+{
+    ASTNode* node;      /**< @brief Node being visited */
+    ASTNode* child;     /**< @brief Last child visited from the current list (or @c NULL) */
+    int step;           /**< @brief Index of next child (or list of children) to visit */
+} TraversalFrame;
+
+/**
+ * @brief Number of frames kept on the C stack before the traversal stack is
+ * moved to the heap (enough for any reasonably-sized program)
+ */
+#define TRAVERSAL_STACK_SIZE 256
+
+/**
+ * @brief Advance to the next node in a list of children
+ *
+ * @returns Next child or @c NULL at the end of the list (in which case the
+ * frame moves on to its next step)
+ */
+ASTNode* TraversalFrame_next_in_list (TraversalFrame* frame, NodeList* list)
+{
+    frame->child = (frame->child == NULL ? list->head : frame->child->next);
+    if (frame->child == NULL) {
+        frame->step++;
+    }
+    return frame->child;
+}
+
+/**
+ * @brief Find the next child of a node to visit
+ *
+ * Children are read only when they are about to be visited, at the same time
+ * that the recursive traversal would read them. Optional children are always
+ * last, so a @c NULL child ends the node.
+ *
+ * @returns Next child or @c NULL if all children have been visited
+ */
+ASTNode* TraversalFrame_next_child (NodeVisitor* visitor, TraversalFrame* frame)
+{
+    ASTNode* node = frame->node;
+    ASTNode* child = NULL;
+    switch (node->type)
+    {
+        case PROGRAM:
+            if (frame->step == 0) {
+                child = TraversalFrame_next_in_list(frame, node->program.variables);
+            }
+            if (frame->step == 1) {
+                child = TraversalFrame_next_in_list(frame, node->program.functions);
+            }
+            return child;
+
+        case BLOCK:
+            if (frame->step == 0) {
+                child = TraversalFrame_next_in_list(frame, node->block.variables);
+            }
+            if (frame->step == 1) {
+                child = TraversalFrame_next_in_list(frame, node->block.statements);
+            }
+            return child;
+
+        case FUNCCALL:
+            if (frame->step == 0) {
+                child = TraversalFrame_next_in_list(frame, node->funccall.arguments);
+            }
+            return child;
+
+        case FUNCDECL:
+            switch (frame->step++) {
+                case 0:  return node->funcdecl.body;
+                default: return NULL;
+            }
+
+        case ASSIGNMENT:
+            switch (frame->step++) {
+                case 0:  return node->assignment.location;
+                case 1:  return node->assignment.value;
+                default: return NULL;
+            }
+
+        case CONDITIONAL:
+            switch (frame->step++) {
+                case 0:  return node->conditional.condition;
+                case 1:  return node->conditional.if_block;
+                case 2:  return node->conditional.else_block;
+                default: return NULL;
+            }
+
+        case WHILELOOP:
+            switch (frame->step++) {
+                case 0:  return node->whileloop.condition;
+                case 1:  return node->whileloop.body;
+                default: return NULL;
+            }
+
+        case RETURNSTMT:
+            switch (frame->step++) {
+                case 0:  return node->funcreturn.value;
+                default: return NULL;
+            }
+
+        case BINARYOP:
+            switch (frame->step++) {
+                case 0:
+                    return node->binaryop.left;
+                case 1:
+                    if (visitor->invisit_binaryop != NULL) {
+                        visitor->invisit_binaryop(visitor, node);
+                    }
+                    return node->binaryop.right;
+                default:
+                    return NULL;
+            }
+
+        case UNARYOP:
+            switch (frame->step++) {
+                case 0:  return node->unaryop.child;
+                default: return NULL;
+            }
+
+        case LOCATION:
+            switch (frame->step++) {
+                case 0:  return node->location.index;
+                default: return NULL;
+            }
+
+        default:
+            return NULL;
+    }
+}
+
+void NodeVisitor_traverse_iterative (NodeVisitor* visitor, ASTNode* node)
+{
+    TraversalFrame local_frames[TRAVERSAL_STACK_SIZE];
+    TraversalFrame* frames = local_frames;
+    int capacity = TRAVERSAL_STACK_SIZE;
+    int size = 0;
+
+    NodeVisitor_previsit(visitor, node);
+    frames[size++] = (TraversalFrame){ node, NULL, 0 };
+    while (size > 0) {
+        ASTNode* child = TraversalFrame_next_child(visitor, &frames[size-1]);
+        if (child == NULL) {
+            /* all children visited */
+            NodeVisitor_postvisit(visitor, frames[--size].node);
+            continue;
+        }
+
+        /* grow the stack (moving it to the heap the first time) */
+        if (size == capacity) {
+            capacity *= 2;
+            if (frames == local_frames) {
+                frames = (TraversalFrame*)malloc(capacity * sizeof(TraversalFrame));
+                CHECK_MALLOC_PTR(frames)
+                memcpy(frames, local_frames, sizeof(local_frames));
+            } else {
+                frames = (TraversalFrame*)realloc(frames, capacity * sizeof(TraversalFrame));
+                CHECK_MALLOC_PTR(frames)
+            }
+        }
+        NodeVisitor_previsit(visitor, child);
+        frames[size++] = (TraversalFrame){ child, NULL, 0 };
+    }
+    if (frames != local_frames) {
+        free(frames);
+    }
+}
+
+/**
+ * @brief Traversal used by @ref NodeVisitor_traverse
+ */
+TraversalImpl traversal_impl = TRAVERSE_ITERATIVE;
+
+void NodeVisitor_select_traversal (TraversalImpl impl)
+{
+    traversal_impl = impl;
+}
+
+void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node)
+{
+    if (traversal_impl == TRAVERSE_RECURSIVE) {
+        NodeVisitor_traverse_recursive(visitor, node);
+    } else {
+        NodeVisitor_traverse_iterative(visitor, node);
+    }
+}
+
 void NodeVisitor_traverse_and_free (NodeVisitor* visitor, ASTNode* node)
 {
     NodeVisitor_traverse(visitor, node);
@@ -195,13 +440,144 @@ void NodeVisitor_free (NodeVisitor* visitor)
 }
 
 
+/*
+ * AST VISITOR: FUSED TRAVERSAL
+ */
+
+/**
+ * @brief Visitors run by a fused visitor
+ */
+typedef struct FusedVisitorData
+{
+    NodeVisitor** visitors;     /**< @brief Visitors in the order they run */
+    int count;                  /**< @brief Number of visitors */
+} FusedVisitorData;
+
+void FusedVisitorData_free (FusedVisitorData* data)
+{
+    for (int i = 0; i < data->count; i++) {
+        NodeVisitor_free(data->visitors[i]);
+    }
+    free(data->visitors);
+    free(data);
+}
+
+/**
+ * @brief Define a fused visitor routine that calls a routine of every visitor
+ * (or its default routine if it does not have one)
+ */
+#define DEF_FUSED_VISIT(VISIT, DEFAULT) \
+    void FusedVisitor_ ## VISIT (NodeVisitor* visitor, ASTNode* node) \
+    { \
+        FusedVisitorData* data = (FusedVisitorData*)visitor->data; \
+        for (int i = 0; i < data->count; i++) { \
+            NodeVisitor* v = data->visitors[i]; \
+            if (v->VISIT != NULL) { v->VISIT(v, node); } \
+                             else { v->DEFAULT(v, node); } \
+        } \
+    }
+
+DEF_FUSED_VISIT( previsit_program,      previsit_default)
+DEF_FUSED_VISIT(postvisit_program,     postvisit_default)
+DEF_FUSED_VISIT( previsit_vardecl,      previsit_default)
+DEF_FUSED_VISIT(postvisit_vardecl,     postvisit_default)
+DEF_FUSED_VISIT( previsit_funcdecl,     previsit_default)
+DEF_FUSED_VISIT(postvisit_funcdecl,    postvisit_default)
+DEF_FUSED_VISIT( previsit_block,        previsit_default)
+DEF_FUSED_VISIT(postvisit_block,       postvisit_default)
+DEF_FUSED_VISIT( previsit_assignment,   previsit_default)
+DEF_FUSED_VISIT(postvisit_assignment,  postvisit_default)
+DEF_FUSED_VISIT( previsit_conditional,  previsit_default)
+DEF_FUSED_VISIT(postvisit_conditional, postvisit_default)
+DEF_FUSED_VISIT( previsit_whileloop,    previsit_default)
+DEF_FUSED_VISIT(postvisit_whileloop,   postvisit_default)
+DEF_FUSED_VISIT( previsit_return,       previsit_default)
+DEF_FUSED_VISIT(postvisit_return,      postvisit_default)
+DEF_FUSED_VISIT( previsit_break,        previsit_default)
+DEF_FUSED_VISIT(postvisit_break,       postvisit_default)
+DEF_FUSED_VISIT( previsit_continue,     previsit_default)
+DEF_FUSED_VISIT(postvisit_continue,    postvisit_default)
+DEF_FUSED_VISIT( previsit_binaryop,     previsit_default)
+DEF_FUSED_VISIT(postvisit_binaryop,    postvisit_default)
+DEF_FUSED_VISIT( previsit_unaryop,      previsit_default)
+DEF_FUSED_VISIT(postvisit_unaryop,     postvisit_default)
+DEF_FUSED_VISIT( previsit_location,     previsit_default)
+DEF_FUSED_VISIT(postvisit_location,    postvisit_default)
+DEF_FUSED_VISIT( previsit_funccall,     previsit_default)
+DEF_FUSED_VISIT(postvisit_funccall,    postvisit_default)
+DEF_FUSED_VISIT( previsit_literal,      previsit_default)
+DEF_FUSED_VISIT(postvisit_literal,     postvisit_default)
+
+void FusedVisitor_invisit_binaryop (NodeVisitor* visitor, ASTNode* node)
+{
+    /* in-visits have no default */
+    FusedVisitorData* data = (FusedVisitorData*)visitor->data;
+    for (int i = 0; i < data->count; i++) {
+        NodeVisitor* v = data->visitors[i];
+        if (v->invisit_binaryop != NULL) {
+            v->invisit_binaryop(v, node);
+        }
+    }
+}
+
+NodeVisitor* FusedVisitor_new (int count, ...)
+{
+    FusedVisitorData* data = (FusedVisitorData*)calloc(1, sizeof(FusedVisitorData));
+    CHECK_MALLOC_PTR(data)
+    data->visitors = (NodeVisitor**)calloc(count, sizeof(NodeVisitor*));
+    CHECK_MALLOC_PTR(data->visitors)
+    data->count = count;
+    va_list args;
+    va_start(args, count);
+    for (int i = 0; i < count; i++) {
+        data->visitors[i] = va_arg(args, NodeVisitor*);
+    }
+    va_end(args);
+
+    NodeVisitor* v = NodeVisitor_new();
+    v->data = data;
+    v->dtor = (Destructor)FusedVisitorData_free;
+    v->previsit_program      = FusedVisitor_previsit_program;
+    v->postvisit_program     = FusedVisitor_postvisit_program;
+    v->previsit_vardecl      = FusedVisitor_previsit_vardecl;
+    v->postvisit_vardecl     = FusedVisitor_postvisit_vardecl;
+    v->previsit_funcdecl     = FusedVisitor_previsit_funcdecl;
+    v->postvisit_funcdecl    = FusedVisitor_postvisit_funcdecl;
+    v->previsit_block        = FusedVisitor_previsit_block;
+    v->postvisit_block       = FusedVisitor_postvisit_block;
+    v->previsit_assignment   = FusedVisitor_previsit_assignment;
+    v->postvisit_assignment  = FusedVisitor_postvisit_assignment;
+    v->previsit_conditional  = FusedVisitor_previsit_conditional;
+    v->postvisit_conditional = FusedVisitor_postvisit_conditional;
+    v->previsit_whileloop    = FusedVisitor_previsit_whileloop;
+    v->postvisit_whileloop   = FusedVisitor_postvisit_whileloop;
+    v->previsit_return       = FusedVisitor_previsit_return;
+    v->postvisit_return      = FusedVisitor_postvisit_return;
+    v->previsit_break        = FusedVisitor_previsit_break;
+    v->postvisit_break       = FusedVisitor_postvisit_break;
+    v->previsit_continue     = FusedVisitor_previsit_continue;
+    v->postvisit_continue    = FusedVisitor_postvisit_continue;
+    v->previsit_binaryop     = FusedVisitor_previsit_binaryop;
+    v->invisit_binaryop      = FusedVisitor_invisit_binaryop;
+    v->postvisit_binaryop    = FusedVisitor_postvisit_binaryop;
+    v->previsit_unaryop      = FusedVisitor_previsit_unaryop;
+    v->postvisit_unaryop     = FusedVisitor_postvisit_unaryop;
+    v->previsit_location     = FusedVisitor_previsit_location;
+    v->postvisit_location    = FusedVisitor_postvisit_location;
+    v->previsit_funccall     = FusedVisitor_previsit_funccall;
+    v->postvisit_funccall    = FusedVisitor_postvisit_funccall;
+    v->previsit_literal      = FusedVisitor_previsit_literal;
+    v->postvisit_literal     = FusedVisitor_postvisit_literal;
+    return v;
+}
+
 /*
  * AST VISITOR: PRETTY PRINTING
  */
 
 #define OUTFILE ((FILE*)visitor->data)
 
-#define PRINT_INDENT    long depth = (long)ASTNode_get_attribute(node, "depth"); \
+#define PRINT_INDENT    long depth = (long)ASTNode_get_slot(node, SLOT_DEPTH); \
                         for (long i = 0; i < depth; i++) { \
                             fprintf(OUTFILE, "  "); \
                         }
@@ -576,8 +952,7 @@ void CalcDepthVisitor_visit_program (NodeVisitor* visitor, ASTNode* node)
 
 void CalcDepthVisitor_visit_nonprogram (NodeVisitor* visitor, ASTNode* node)
 {
-    ASTNode* parent = (ASTNode*)ASTNode_get_attribute(node, "parent");
-    long pdepth = (long)ASTNode_get_int_attribute(parent, "depth");
+    long pdepth = (long)ASTNode_get_slot(node->parent, SLOT_DEPTH);
     ASTNode_set_int_attribute(node, "depth", pdepth + 1);
 }
 
@@ -34,6 +34,40 @@ TEST_INVALID(B_mismatched_parameters, "def int main() { foo(true, true); return
                                       "def void foo(int i, bool b) { return; } ")
 TEST_INVALID(A_invalid_main_var,      "int main; def int foo(int a) { return 0; }")
 
+TEST_SAME_FUSED_SETUP(B_fused_setup, "int g[10]; bool b;\n"
+        "def int f(int x, bool y) { int z; if (y) { int w; z = x + w; } else { z = -g[x]; } return z; }\n"
+        "def int main() { while (b) { f(g[0] * 2, !b); break; } return f(1, true); }")
+TEST_SAME_FUSED_SETUP(B_fused_setup_nested, "def int main() { int a; if (true) { int b; if (true) { int c; a = b + c; } } return a; }")
+
+TEST_SAME_SCOPE_LOOKUP(B_scope_lookup, "int a; bool b;\n"
+        "def int f(int a) { int b; if (true) { bool a; b = 1; if (a) { int c; c = b + f(b); } } return a; }\n"
+        "def int main() { a = f(a); while (b) { int a; a = 2; b = false; } return a; }")
+
+START_TEST (B_large_symbol_table)
+{ ck_assert (large_symbol_table(5000)); }
+END_TEST
+
+START_TEST (B_lookup_does_not_intern)
+{
+    SymbolTable* table = SymbolTable_new();
+    SymbolTable_insert(table, Symbol_new("defined_name", INT));
+    ck_assert_ptr_nonnull (SymbolTable_lookup(table, "defined_name"));
+    ck_assert_ptr_null (SymbolTable_lookup(table, "undefined_name"));
+    ck_assert_ptr_null (find_interned_string("undefined_name"));
+    SymbolTable_free(table);
+}
+END_TEST
+
+START_TEST (B_unresolved_analysis)
+{
+    ck_assert (same_unresolved_analysis("int g[4];\n"
+            "def int f(int a) { g[a] = a; return g[a]; }\n"
+            "def int main() { int x; x = f(1); return x + f(2); }"));
+    ck_assert (same_unresolved_analysis("int g[4];\n"
+            "def int main() { int x; x = g; g[x] = y; return h(x); }"));
+}
+END_TEST
+
 #endif
 
 /**
@@ -60,6 +94,12 @@ void public_tests (Suite *s)
     TEST(B_mismatched_parameters);
 
     TEST(A_invalid_main_var);
+    TEST(B_fused_setup);
+    TEST(B_fused_setup_nested);
+    TEST(B_scope_lookup);
+    TEST(B_large_symbol_table);
+    TEST(B_lookup_does_not_intern);
+    TEST(B_unresolved_analysis);
 
     suite_add_tcase (s, tc);
 }
@@ -20,6 +20,7 @@ ErrorList* run_analysis (char* text)
     NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
     NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
     NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(ResolveSymbolsVisitor_new(), tree);
     return analyze(tree);
 }
 
@@ -35,6 +36,130 @@ bool invalid_program (char* text)
     return errors == NULL || !ErrorList_is_empty(errors);
 }
 
+/**
+ * @brief Set up a tree with separate or fused visitors and print it (indented
+ * by depth) along with its symbol tables
+ *
+ * @returns Printed output (caller must free) or @c NULL if there was an error
+ */
+char* print_setup (char* text, bool fused)
+{
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        tree = parse(lex(text));
+    } else {
+        return NULL;
+    }
+    if (fused) {
+        NodeVisitor_traverse_and_free(FusedVisitor_new(3,
+                SetParentVisitor_new(), CalcDepthVisitor_new(),
+                BuildSymbolTablesVisitor_new()), tree);
+    } else {
+        NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
+        NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+        NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    }
+    FILE* out = tmpfile();
+    NodeVisitor_traverse_and_free(PrintSymbolsVisitor_new(out), tree);
+    NodeVisitor_traverse_and_free(PrintVisitor_new(out), tree);
+    ASTNode_free(tree);
+    long size = ftell(out);
+    char* printed = (char*)calloc(size + 1, 1);
+    rewind(out);
+    if (fread(printed, 1, size, out) != (size_t)size) {
+        printed[0] = '\0';
+    }
+    fclose(out);
+    return printed;
+}
+
+bool same_fused_setup (char* text)
+{
+    char* expected = print_setup(text, false);
+    char* printed = print_setup(text, true);
+    bool same = (expected == NULL || printed == NULL) ? (expected == printed)
+                                                      : (strcmp(expected, printed) == 0);
+    free(expected);
+    free(printed);
+    return same;
+}
+
+/**
+ * @brief Check a name reference: the symbol bound to the node and the lookup
+ * through the node's recorded scope must find the same symbol as a lookup that
+ * walks up the tree
+ */
+void ScopeCheckVisitor_check (NodeVisitor* visitor, ASTNode* node)
+{
+    const char* name = (node->type == LOCATION ? node->location.name : node->funccall.name);
+    Symbol* bound = node->symbol;
+    node->symbol = NULL;
+    Symbol* cached = lookup_symbol(node, name);
+    SymbolTable* scope = node->scope;
+    node->scope = NULL;
+    Symbol* walked = lookup_symbol(node, name);
+    node->scope = scope;
+    node->symbol = bound;
+    if (scope == NULL || bound == NULL || bound != walked || cached != walked ||
+            node->parent != ASTNode_get_attribute(node, "parent")) {
+        *(bool*)visitor->data = false;
+    }
+}
+
+bool same_scope_lookup (char* text)
+{
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        tree = parse(lex(text));
+    } else {
+        return false;
+    }
+    NodeVisitor_traverse_and_free(FusedVisitor_new(4,
+            SetParentVisitor_new(), CalcDepthVisitor_new(),
+            BuildSymbolTablesVisitor_new(), ResolveSymbolsVisitor_new()), tree);
+    bool same = true;
+    NodeVisitor* v = NodeVisitor_new();
+    v->data = &same;
+    v->previsit_location = ScopeCheckVisitor_check;
+    v->previsit_funccall = ScopeCheckVisitor_check;
+    NodeVisitor_traverse_and_free(v, tree);
+    ASTNode_free(tree);
+    return same;
+}
+
+bool large_symbol_table (int count)
+{
+    /* global scope with many symbols, a duplicate, and a shadowing child */
+    char name[MAX_ID_LEN];
+    SymbolTable* global = SymbolTable_new();
+    for (int i = 0; i < count; i++) {
+        snprintf(name, MAX_ID_LEN, "v%d", i);
+        SymbolTable_insert(global, Symbol_new(name, INT));
+    }
+    SymbolTable_insert(global, Symbol_new("v0", BOOL));
+    SymbolTable* local = SymbolTable_new_child(global);
+    Symbol* shadow = Symbol_new("v1", BOOL);
+    SymbolTable_insert(local, shadow);
+
+    bool valid = (SymbolTable_lookup(global, "v0")->type == INT) &&
+                 (SymbolTable_lookup(local, "v1") == shadow) &&
+                 (SymbolTable_lookup(local, "missing") == NULL);
+    for (int i = 2; valid && i < count; i++) {
+        snprintf(name, MAX_ID_LEN, "v%d", i);
+        Symbol* symbol = SymbolTable_lookup(local, name);
+        valid = (symbol != NULL && strcmp(symbol->name, name) == 0);
+    }
+
+    /* symbols added directly to the list must be found as well */
+    Symbol* extra = Symbol_new("extra", INT);
+    SymbolList_add(global->local_symbols, extra);
+    valid = valid && (SymbolTable_lookup(local, "extra") == extra);
+
+    SymbolTable_free(local);
+    SymbolTable_free(global);
+    return valid;
+}
+
 extern void public_tests (Suite *s);
 extern void private_tests (Suite *s);
 
@@ -60,3 +185,19 @@ int main (void)
     run_testsuite ();
     return EXIT_SUCCESS;
 }
+
+bool same_unresolved_analysis (char* text)
+{
+    ErrorList* resolved = run_analysis(text);
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        tree = parse(lex(text));
+    } else {
+        return resolved == NULL;
+    }
+    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    ErrorList* unresolved = analyze(tree);
+    return resolved != NULL && ErrorList_size(resolved) == ErrorList_size(unresolved);
+}
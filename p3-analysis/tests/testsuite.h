@@ -44,6 +44,22 @@ END_TEST
 { ck_assert (invalid_program("def int main () { " TEXT " }")); } \
 END_TEST
 
+/**
+ * @brief Define a test case that checks that fused and separate setup
+ * traversals produce the same symbol tables and node depths
+ */
+#define TEST_SAME_FUSED_SETUP(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_fused_setup(TEXT)); } \
+END_TEST
+
+/**
+ * @brief Define a test case that checks symbol bindings and lookups through
+ * recorded scopes
+ */
+#define TEST_SAME_SCOPE_LOOKUP(NAME,TEXT) START_TEST (NAME) \
+{ ck_assert (same_scope_lookup(TEXT)); } \
+END_TEST
+
 /**
  * @brief Add a test to the test suite
  */
@@ -73,3 +89,45 @@ bool invalid_program (char* text);
  * @returns True if and only if the text was lexed and parsed successfully
  */
 bool valid_program (char* text);
+
+/**
+ * @brief Set up the tree for the given text with separate and with fused
+ * visitors (see @ref FusedVisitor_new) and verify that the symbol tables and
+ * printed trees (indented by node depth) are identical.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if both failed or both produced the same output
+ */
+bool same_fused_setup (char* text);
+
+/**
+ * @brief Set up the tree for the given text (including name resolution) and
+ * verify that every location and function call is bound to a symbol and finds
+ * the same symbol through its recorded scope as by walking up the tree through
+ * parent links.
+ *
+ * @param text Code to lex and parse
+ * @returns True if and only if the text parsed and all lookups matched
+ */
+bool same_scope_lookup (char* text);
+
+/**
+ * @brief Build a global symbol table with the given number of symbols (large
+ * enough to be indexed) and a child table, and verify that lookups find the
+ * first declaration of each name, respect shadowing, and also find symbols
+ * added directly to the symbol list.
+ *
+ * @param count Number of global symbols
+ * @returns True if and only if all lookups were correct
+ */
+bool large_symbol_table (int count);
+
+/**
+ * @brief Analyze the given text with and without running a
+ * ResolveSymbolsVisitor first and verify that both report the same number of
+ * errors.
+ *
+ * @param text Code to lex, parse, and analyze
+ * @returns True if and only if the text parsed and both analyses agreed
+ */
+bool same_unresolved_analysis (char* text);
@@ -26,13 +26,16 @@
 #include <setjmp.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 /**
- * @brief Maximum size (in bytes) of any Decaf source file
+ * @brief Maximum size (in bytes) of Decaf source text in fixed-size buffers
+ *
+ * Source files read with @ref SourceText_read are not subject to this limit.
  */
 #define MAX_FILE_SIZE 65536
 
@@ -93,6 +96,78 @@ void print_escaped_string(const char* string, FILE* output);
  */
 void print_doubly_escaped_string(const char* string, FILE* output);
 
+/**
+ * @brief Return the canonical (interned) copy of a string
+ *
+ * Every distinct string is stored once in a global hash table, so two
+ * interned strings are equal if and only if their pointers are equal. The
+ * returned string must not be modified or freed; it remains valid until
+ * @ref free_interned_strings is called.
+ *
+ * @param string String to intern
+ * @returns Canonical copy of @p string
+ */
+const char* intern_string (const char* string);
+
+/**
+ * @brief Return the canonical (interned) copy of the first @p len characters
+ * of a string (see @ref intern_string)
+ *
+ * @param string Start of string to intern (need not be NUL-terminated)
+ * @param len Number of characters to intern
+ * @returns Canonical copy of the characters
+ */
+const char* intern_string_len (const char* string, size_t len);
+
+/**
+ * @brief Look up the canonical copy of a string without interning it
+ *
+ * Unlike @ref intern_string, this never adds to the table, so probing for
+ * names that were never interned does not grow it.
+ *
+ * @param string String to look up
+ * @returns Canonical copy of @p string (or @c NULL if it has not been interned)
+ */
+const char* find_interned_string (const char* string);
+
+/**
+ * @brief Deallocate every interned string
+ */
+void free_interned_strings (void);
+
+/**
+ * @brief Contents of a source file
+ *
+ * The text is always NUL-terminated (at @c text[length]) and may be memory
+ * mapped, so it must not be modified.
+ *
+ * Allocate with @ref SourceText_read and de-allocate with @ref SourceText_free.
+ */
+typedef struct SourceText
+{
+    const char* text;   /**< @brief File contents */
+    size_t length;      /**< @brief Length of the contents in bytes */
+    bool mapped;        /**< @brief True if @c text is memory mapped (otherwise heap-allocated) */
+} SourceText;
+
+/**
+ * @brief Read an entire source file of any size
+ *
+ * Regular files are memory mapped when possible; pipes and standard input
+ * (filename @c "-") are read with bulk @c read calls into a growing buffer.
+ *
+ * @param filename Name of file to read (or @c "-" for standard input)
+ * @returns Newly-created source text (or @c NULL if the file could not be read)
+ */
+SourceText* SourceText_read (const char* filename);
+
+/**
+ * @brief Deallocate (or unmap) source text
+ *
+ * @param source Source text to deallocate
+ */
+void SourceText_free (SourceText* source);
+
 /**
  * @brief Throw an exception with an error message using @c printf syntax
  *
@@ -166,9 +241,25 @@ void Error_throw_printf (const char* format, ...);
  * @param FREEFUNC Name of the function to call to deallocate each element
  */
 #define DEF_LIST_IMPL(NAME, ELEMTYPE, FREEFUNC) \
+    DEF_LIST_IMPL_ALLOC(NAME, ELEMTYPE, FREEFUNC, calloc, free)
+
+/**
+ * @brief Define a list implementation with a custom allocator
+ *
+ * Same as @ref DEF_LIST_IMPL, but the list structure itself is allocated with
+ * @c ALLOCFUNC (which must have the same signature and zero-filling behavior
+ * as @c calloc) and deallocated with @c DEALLOCFUNC.
+ *
+ * @param NAME Prefix for the list struct name (actual name will be @c NAMEList)
+ * @param ELEMTYPE Type of the elements to be stored (must be a struct pointer)
+ * @param FREEFUNC Name of the function to call to deallocate each element
+ * @param ALLOCFUNC Name of the function to call to allocate the list
+ * @param DEALLOCFUNC Name of the function to call to deallocate the list
+ */
+#define DEF_LIST_IMPL_ALLOC(NAME, ELEMTYPE, FREEFUNC, ALLOCFUNC, DEALLOCFUNC) \
     NAME ## List* NAME ## List_new (void) \
     { \
-        NAME ## List* list = (NAME ## List*)calloc(1, sizeof(NAME ## List)); \
+        NAME ## List* list = (NAME ## List*)ALLOCFUNC(1, sizeof(NAME ## List)); \
         CHECK_MALLOC_PTR(list); \
         list->head = NULL; \
         list->tail = NULL; \
@@ -202,7 +293,7 @@ void Error_throw_printf (const char* format, ...);
             next = cur->next; \
             FREEFUNC(cur); \
         } \
-        free(list); \
+        DEALLOCFUNC(list); \
     }
 
 /**
@@ -20,4 +20,17 @@
  */
 InsnList* generate_code (ASTNode* tree);
 
+/**
+ * @brief Convert an AST into linear ILOC code, optionally with array bounds checks
+ * 
+ * In checked mode, array accesses are preceded by a @c BOUNDS instruction
+ * unless the index is provably in range (an in-range literal or a loop
+ * variable bounded by the loop condition).
+ * 
+ * @param tree Root of AST
+ * @param bounds_check Emit runtime array bounds checks
+ * @returns List of ILOC instructions
+ */
+InsnList* generate_checked_code (ASTNode* tree, bool bounds_check);
+
 #endif
@@ -89,12 +89,58 @@ NodeVisitor* NodeVisitor_new(void);
 /**
  * @brief Perform an AST traversal using the given visitor
  * 
+ * By default this uses @ref NodeVisitor_traverse_iterative, so very deep trees
+ * (e.g., long chains of binary operators) cannot overflow the C stack. Use
+ * @ref NodeVisitor_select_traversal to switch to the recursive traversal.
+ *
  * @param visitor Visitor structure containing function pointers that will be
  * invoked during the traversal
  * @param node Root of AST structure to traverse
  */
 void NodeVisitor_traverse (NodeVisitor* visitor, ASTNode* node);
 
+/**
+ * @brief Perform an AST traversal using an explicit stack
+ *
+ * Routines are invoked in exactly the same order as
+ * @ref NodeVisitor_traverse_recursive (including in-visits between the two
+ * operands of a binary operator), and each child is read when the traversal
+ * reaches it, so visitors can modify nodes that have not been visited yet.
+ *
+ * @param visitor Visitor structure containing function pointers that will be
+ * invoked during the traversal
+ * @param node Root of AST structure to traverse
+ */
+void NodeVisitor_traverse_iterative (NodeVisitor* visitor, ASTNode* node);
+
+/**
+ * @brief Perform an AST traversal using recursive calls (one C stack frame per
+ * level of the tree; easier to follow in a debugger)
+ *
+ * @param visitor Visitor structure containing function pointers that will be
+ * invoked during the traversal
+ * @param node Root of AST structure to traverse
+ */
+void NodeVisitor_traverse_recursive (NodeVisitor* visitor, ASTNode* node);
+
+/**
+ * @brief AST traversal strategies
+ */
+typedef enum TraversalImpl
+{
+    TRAVERSE_ITERATIVE,     /**< @brief Explicit stack (default) */
+    TRAVERSE_RECURSIVE      /**< @brief Recursive calls (for debugging) */
+} TraversalImpl;
+
+/**
+ * @brief Select the traversal used by @ref NodeVisitor_traverse
+ *
+ * Both invoke the visitor routines in the same order.
+ *
+ * @param impl Traversal to use
+ */
+void NodeVisitor_select_traversal (TraversalImpl impl);
+
 /**
  * @brief Perform an AST traversal using the given visitor and then deallocate the visitor
  * 
@@ -116,6 +162,28 @@ void NodeVisitor_traverse_and_free (NodeVisitor* visitor, ASTNode* node);
  */
 void NodeVisitor_free (NodeVisitor* visitor);
 
+/**
+ * @brief Create a visitor that runs several visitors in a single traversal
+ *
+ * At every node, each visitor's pre-visit (or in-visit or post-visit)
+ * routine is called in the order that the visitors were given. Each visitor
+ * receives its own structure, so its @c data member works as usual. The
+ * result is the same as running the visitors one after another as long as no
+ * visitor reads anything at a node that a later visitor only writes
+ * afterwards (e.g., running @ref CalcDepthVisitor_new after
+ * @ref SetParentVisitor_new is fine because parent links are set from the
+ * parent's pre-visit). For example:
+ *
+ *     NodeVisitor_traverse_and_free(FusedVisitor_new(2,
+ *             SetParentVisitor_new(), CalcDepthVisitor_new()), tree);
+ *
+ * @param count Number of visitors
+ * @param ... Visitors to run (@c NodeVisitor*); these are deallocated along
+ * with the fused visitor
+ * @returns Pointer to visitor structure
+ */
+NodeVisitor* FusedVisitor_new (int count, ...);
+
 
 /*
  * VISITORS
@@ -43,31 +43,6 @@ void Error_throw_printf (const char* format, ...)
     longjmp(decaf_error, 1);
 }
 
-/**
- * @brief Read all text data from a file
- *
- * @param filename Name of file to read
- * @param text String buffer destination (must be #MAX_FILE_SIZE characters long)
- * @returns True if and only if the file read was successful.
- */
-bool read_file (const char* filename, char* text)
-{
-    FILE* input = fopen(filename, "r");
-    if (input == NULL) {
-        return false;
-    }
-    size_t nchars = 0;
-    char* p = text;
-    int c;
-    while (nchars < MAX_FILE_SIZE && (c = fgetc(input)) != EOF) {
-        *p++ = (char)c;
-        nchars++;
-    }
-    *p = '\0';
-    fclose(input);
-    return true;
-}
-
 /**
  * @brief Compiler entry point
  *
@@ -78,20 +53,28 @@ bool read_file (const char* filename, char* text)
  */
 int main(int argc, char** argv)
 {
-    /* check for filename */
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <decaf-filename>\n", argv[0]);
+    /* check for options and filename */
+    bool bounds_check = false;
+    if (argc == 3 && strcmp(argv[1], "--bounds-check") == 0) {
+        bounds_check = true;
+    } else if (argc != 2) {
+        fprintf(stderr, "Usage: %s [--bounds-check] <decaf-filename>\n", argv[0]);
         return EXIT_FAILURE;
     }
     char* filename = argv[argc-1];
 
     /* read file */
-    char text[MAX_FILE_SIZE];
-    if (!read_file(filename, text)) {
+    SourceText* source = SourceText_read(filename);
+    if (source == NULL) {
         fprintf(stderr, "Could not read file: %s", filename);
         exit(EXIT_FAILURE);
     }
 
+    /* allocate the AST in an arena (set DECAF_NO_ARENA in the environment to
+     * allocate each object individually, e.g., for valgrind) */
+    ASTArena* arena = (getenv("DECAF_NO_ARENA") == NULL ? ASTArena_new() : NULL);
+    ASTArena_use(arena);
+
     /* FRONT END */
 
     TokenQueue* tokens = NULL;
@@ -101,7 +84,11 @@ int main(int argc, char** argv)
     if (setjmp(decaf_error) == 0) {
 
         /* PROJECT 1: lexer */
-        tokens = lex(text);
+        tokens = lex(source->text);
+
+        /* clean up source text (tokens hold copies of their text) */
+        SourceText_free(source);
+        source = NULL;
 
         /* PROJECT 2: parser */
         tree = parse(tokens);
@@ -114,19 +101,20 @@ int main(int argc, char** argv)
 
         /* handle fatal error: print message and clean up */
         fprintf(stderr, "%s", decaf_error_msg);
+        if (source   != NULL) SourceText_free(source);
         if (tokens   != NULL) TokenQueue_free(tokens);
         if (tree     != NULL) ASTNode_free(tree);
+        ASTArena_free(arena);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
-    /* set up parent links and calculate node depths */
-    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
-    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
-
-    /* MIDDLE END */
-
-    /* build symbol tables */
-    NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    /* set up parent links, calculate node depths, and (MIDDLE END) build
+     * symbol tables and bind each name to its symbol, all in a single
+     * traversal */
+    NodeVisitor_traverse_and_free(FusedVisitor_new(4,
+            SetParentVisitor_new(), CalcDepthVisitor_new(),
+            BuildSymbolTablesVisitor_new(), ResolveSymbolsVisitor_new()), tree);
 
     /* PROJECT 3: analysis */
     ErrorList* errors = analyze(tree);
@@ -139,7 +127,9 @@ int main(int argc, char** argv)
     /* abort if analysis has reported errors */
     if (!ErrorList_is_empty(errors)) {
         ASTNode_free(tree);
+        ASTArena_free(arena);
         ErrorList_free(errors);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
@@ -153,7 +143,7 @@ int main(int argc, char** argv)
     NodeVisitor_traverse_and_free(AllocateSymbolsVisitor_new(), tree);
 
     /* PROJECT 4: code gen */
-    InsnList* iloc = generate_code(tree);
+    InsnList* iloc = generate_checked_code(tree, bounds_check);
 
     /* generate graphical AST */
     FILE* graph_file = fopen("iloc-tree.dot", "w");
@@ -167,6 +157,7 @@ int main(int argc, char** argv)
 
     /* clean up syntax tree (no longer needed) */
     ASTNode_free(tree);
+    ASTArena_free(arena);
     tree = NULL;
 
     /* print ILOC if debug mode is enabled */
@@ -181,6 +172,7 @@ int main(int argc, char** argv)
     /* clean up ILOC code (no longer needed) */
     InsnList_free(iloc);
     iloc = NULL;
+    free_interned_strings();
 
     return EXIT_SUCCESS;
 }
@@ -26,6 +26,11 @@ typedef struct CodeGenData
     Operand if_body_label[100];
     Operand if_end_label[100];
 
+    /**
+     * @brief Emit runtime bounds checks for array accesses
+     */
+    bool bounds_check;
+
 
     /* add any new desired state information (and clean it up in CodeGenData_free) */
 } CodeGenData;
@@ -108,6 +113,195 @@ Operand var_offset (ASTNode* node, Symbol* variable)
     return op;
 }
 
+/**
+ * @brief State for the variable write search visitor
+ */
+typedef struct VarWriteData
+{
+    /**
+     * @brief Variable being searched for
+     */
+    Symbol* var;
+
+    /**
+     * @brief True if any assignment writes the variable
+     */
+    bool written;
+
+    /**
+     * @brief True if every assignment to the variable only adds a non-negative literal to it
+     */
+    bool increasing;
+} VarWriteData;
+
+/**
+ * @brief Checks whether a node is a scalar reference to a specific variable
+ */
+bool is_var_ref (ASTNode* node, Symbol* var)
+{
+    return node->type == LOCATION && node->location.index == NULL &&
+           lookup_symbol(node, node->location.name) == var;
+}
+
+/**
+ * @brief assignment pre visit for the variable write search
+ * 
+ * @param visitor 
+ * @param node 
+ */
+void VarWriteVisitor_previsit_assignment (NodeVisitor* visitor, ASTNode* node)
+{
+    VarWriteData* data = (VarWriteData*)visitor->data;
+    if (!is_var_ref(node->assignment.location, data->var)) {
+        return;
+    }
+    data->written = true;
+
+    /* only "v = v + c" or "v = c + v" with c >= 0 keeps the variable increasing */
+    ASTNode* value = node->assignment.value;
+    if (value->type != BINARYOP || value->binaryop.operator != ADDOP) {
+        data->increasing = false;
+    } else if (is_var_ref(value->binaryop.left, data->var)) {
+        data->increasing &= value->binaryop.right->type == LITERAL &&
+                            value->binaryop.right->literal.integer >= 0;
+    } else if (is_var_ref(value->binaryop.right, data->var)) {
+        data->increasing &= value->binaryop.left->type == LITERAL &&
+                            value->binaryop.left->literal.integer >= 0;
+    } else {
+        data->increasing = false;
+    }
+}
+
+/**
+ * @brief Searches a subtree for assignments to a variable
+ * 
+ * @param node Root of the subtree
+ * @param var Variable to search for
+ * @returns Search results
+ */
+VarWriteData find_var_writes (ASTNode* node, Symbol* var)
+{
+    VarWriteData data = { .var = var, .written = false, .increasing = true };
+    NodeVisitor* v = NodeVisitor_new();
+    v->data = &data;
+    v->previsit_assignment = VarWriteVisitor_previsit_assignment;
+    NodeVisitor_traverse_and_free(v, node);
+    return data;
+}
+
+/**
+ * @brief Checks whether a loop condition keeps a variable below a bound
+ * 
+ * Recognizes "v < c" and "v <= c" (and the mirrored "c > v" and "c >= v")
+ * where c is a literal.
+ * 
+ * @param cond Loop condition
+ * @param var Loop variable
+ * @param length Exclusive upper bound
+ * @returns True if the condition guarantees that @p var is less than @p length
+ */
+bool cond_bounds_var (ASTNode* cond, Symbol* var, int length)
+{
+    if (cond->type != BINARYOP) {
+        return false;
+    }
+    ASTNode* left = cond->binaryop.left;
+    ASTNode* right = cond->binaryop.right;
+    switch (cond->binaryop.operator) {
+        case LTOP: return is_var_ref(left, var)  && right->type == LITERAL && right->literal.integer <= length;
+        case LEOP: return is_var_ref(left, var)  && right->type == LITERAL && right->literal.integer <  length;
+        case GTOP: return is_var_ref(right, var) && left->type  == LITERAL && left->literal.integer  <= length;
+        case GEOP: return is_var_ref(right, var) && left->type  == LITERAL && left->literal.integer  <  length;
+        default:   return false;
+    }
+}
+
+/**
+ * @brief Checks whether a variable is non-negative when a loop is entered
+ * 
+ * Scans backwards from the loop for the last statement in the enclosing
+ * block that assigns the variable, which must assign a non-negative literal.
+ * 
+ * @param loop While loop node
+ * @param var Loop variable
+ * @returns True if @p var holds a non-negative literal on loop entry
+ */
+bool var_nonneg_on_entry (ASTNode* loop, Symbol* var)
+{
+    ASTNode* block = loop->parent;
+    if (block == NULL || block->type != BLOCK) {
+        return false;
+    }
+
+    bool result = false;
+    FOR_EACH(ASTNode*, stmt, block->block.statements) {
+        if (stmt == loop) {
+            return result;
+        }
+        if (stmt->type == ASSIGNMENT && is_var_ref(stmt->assignment.location, var)) {
+            result = stmt->assignment.value->type == LITERAL &&
+                     stmt->assignment.value->literal.integer >= 0;
+        } else if (find_var_writes(stmt, var).written) {
+            result = false;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether a bounds check for an array access is provably redundant
+ * 
+ * A check is redundant if the index is a literal within the array bounds, or
+ * if the index is a local loop variable that is a non-negative literal on
+ * loop entry, only ever increases, is bounded above by the loop condition,
+ * and has not been modified in the loop body before the access.
+ * 
+ * @param location Array location node
+ * @param array Array symbol
+ * @returns True if the access is always in range
+ */
+bool bounds_check_is_redundant (ASTNode* location, Symbol* array)
+{
+    ASTNode* index = location->location.index;
+    if (index->type == LITERAL) {
+        return index->literal.integer >= 0 && index->literal.integer < array->length;
+    }
+    if (index->type != LOCATION || index->location.index != NULL) {
+        return false;
+    }
+
+    /* locals cannot be modified by function calls */
+    Symbol* var = lookup_symbol(index, index->location.name);
+    if (var == NULL || var->symbol_type != SCALAR_SYMBOL || var->location == STATIC_VAR) {
+        return false;
+    }
+
+    /* walk up through enclosing loops, tracking the body statement containing the access */
+    ASTNode* stmt = NULL;
+    ASTNode* child = location;
+    for (ASTNode* n = location->parent; n != NULL; n = n->parent)
+    {
+        if (n->type == WHILELOOP && child == n->whileloop.body && stmt != NULL &&
+            cond_bounds_var(n->whileloop.condition, var, array->length))
+        {
+            VarWriteData body = find_var_writes(n->whileloop.body, var);
+            bool unmodified = true;
+            FOR_EACH(ASTNode*, s, n->whileloop.body->block.statements) {
+                unmodified &= !find_var_writes(s, var).written;
+                if (s == stmt) {
+                    break;
+                }
+            }
+            if (unmodified && body.increasing && var_nonneg_on_entry(n, var)) {
+                return true;
+            }
+        }
+        stmt = child;
+        child = n;
+    }
+    return false;
+}
+
 #ifndef SKIP_IN_DOXYGEN
 
 /*
@@ -341,6 +535,76 @@ void CodeGenVisitor_gen_unaryop (NodeVisitor* visitor, ASTNode* node)
     ASTNode_set_temp_reg(node, reg);
 }
 
+/**
+ * @brief Emits a conditional branch on a condition expression
+ * 
+ * If the condition is a comparison, the compare is fused with the branch
+ * instead of materializing a boolean and branching on it: the inverted
+ * comparison (e.g., @c CBR_GE for @c <) jumps to @p if_false and otherwise
+ * falls through. Callers must emit the @p if_true label immediately after.
+ * 
+ * @param node AST node to emit code into
+ * @param cond Condition expression
+ * @param if_true Label to branch to if the condition holds
+ * @param if_false Label to branch to otherwise
+ */
+void emit_cond_branch (ASTNode* node, ASTNode* cond, Operand if_true, Operand if_false)
+{
+    InsnForm form = CBR;
+    if (cond->type == BINARYOP) {
+        switch (cond->binaryop.operator) {
+            case LTOP:  form = CBR_GE; break;
+            case LEOP:  form = CBR_GT; break;
+            case EQOP:  form = CBR_NE; break;
+            case GEOP:  form = CBR_LT; break;
+            case GTOP:  form = CBR_LE; break;
+            case NEQOP: form = CBR_EQ; break;
+            default:
+                break;
+        }
+    }
+
+    if (form == CBR) {
+        ASTNode_copy_code(node, cond);
+        EMIT3OP(CBR, ASTNode_get_temp_reg(cond), if_true, if_false);
+    } else {
+        /* skip the comparison's own code and branch on its operands */
+        ASTNode_copy_code(node, cond->binaryop.left);
+        ASTNode_copy_code(node, cond->binaryop.right);
+        EMIT3OP(form, ASTNode_get_temp_reg(cond->binaryop.left),
+                ASTNode_get_temp_reg(cond->binaryop.right), if_false);
+    }
+}
+
+/**
+ * @brief Emits a bounds check for an array access (in checked mode only)
+ * 
+ * Must be called after the index code has been emitted. Checks that are
+ * provably redundant are omitted.
+ * 
+ * @param visitor Code generation visitor
+ * @param node AST node to emit code into
+ * @param location Array location node
+ * @param array Array symbol
+ */
+void emit_bounds_check (NodeVisitor* visitor, ASTNode* node, ASTNode* location, Symbol* array)
+{
+    if (!DATA->bounds_check || bounds_check_is_redundant(location, array)) {
+        return;
+    }
+
+    ASTNode* index = location->location.index;
+    Operand index_reg;
+    if (index->type == LITERAL) {
+        /* out-of-range literal; its code was folded away */
+        index_reg = virtual_register();
+        EMIT2OP(LOAD_I, int_const(index->literal.integer), index_reg);
+    } else {
+        index_reg = ASTNode_get_temp_reg(index);
+    }
+    EMIT2OP(BOUNDS, index_reg, int_const(array->length));
+}
+
 /**
  * @brief pre while visit
  * 
@@ -368,9 +632,8 @@ void CodeGenVisitor_gen_post_while(NodeVisitor* visitor, ASTNode* node)
     int current_index = DATA->while_count;
 
     EMIT1OP(LABEL, DATA->loop_label[current_index]);
-    ASTNode_copy_code(node, node->whileloop.condition);
-    EMIT3OP(CBR, ASTNode_get_temp_reg(node->whileloop.condition), 
-            DATA->body_label[current_index], 
+    emit_cond_branch(node, node->whileloop.condition,
+            DATA->body_label[current_index],
             DATA->end_label[current_index]);
 
     EMIT1OP(LABEL, DATA->body_label[current_index]);
@@ -425,24 +688,34 @@ void GenCodeVisitor_gen_post_continue(NodeVisitor* visitor, ASTNode* node)
 void CodeGenVisitor_gen_assign(NodeVisitor* visitor, ASTNode* node)
 {
     // Retrieve the symbol for the variable being assigned
-    Symbol* var = lookup_symbol(node, node->assignment.location->location.name);
+    Symbol* var = lookup_symbol(node->assignment.location,
+            node->assignment.location->location.name);
 
     // Check if the symbol represents an array type
     if (var != NULL && var->symbol_type == ARRAY_SYMBOL) {
-        // Handle array index and calculate offset before evaluating the value
-        ASTNode_copy_code(node, node->assignment.location->location.index);
-        Operand index_reg = ASTNode_get_temp_reg(node->assignment.location->location.index);
-
-        Operand lhs_base = var_base(node, var);
-        Operand temp_reg = virtual_register();
-        EMIT3OP(MULT_I, index_reg, int_const(8), temp_reg);
-
-        // Now evaluate the value to be stored
-        ASTNode_copy_code(node, node->assignment.value);
-        Operand rhs_reg = ASTNode_get_temp_reg(node->assignment.value);
-
-        // Store the RHS result into the calculated offset of the array
-        EMIT3OP(STORE_AO, rhs_reg, lhs_base, temp_reg);
+        ASTNode* index = node->assignment.location->location.index;
+
+        if (index->type == LITERAL) {
+            // Literal index; fold it into the displacement
+            emit_bounds_check(visitor, node, node->assignment.location, var);
+            Operand lhs_base = var_base(node, var);
+            ASTNode_copy_code(node, node->assignment.value);
+            Operand rhs_reg = ASTNode_get_temp_reg(node->assignment.value);
+            EMIT3OP(STORE_AI, rhs_reg, lhs_base, int_const(index->literal.integer * WORD_SIZE));
+        } else {
+            // Handle array index before evaluating the value
+            ASTNode_copy_code(node, index);
+            emit_bounds_check(visitor, node, node->assignment.location, var);
+            Operand index_reg = ASTNode_get_temp_reg(index);
+            Operand lhs_base = var_base(node, var);
+
+            // Now evaluate the value to be stored
+            ASTNode_copy_code(node, node->assignment.value);
+            Operand rhs_reg = ASTNode_get_temp_reg(node->assignment.value);
+
+            // Store the RHS result at base + index * WORD_SIZE
+            EMIT3OP(STORE_AS, rhs_reg, lhs_base, index_reg);
+        }
     } else {
         // Handle normal scalar assignments
         ASTNode_copy_code(node, node->assignment.value);
@@ -480,9 +753,8 @@ void GenCodeVisitor_gen_post_conditional(NodeVisitor* visitor, ASTNode* node)
 {
     int current_index = DATA->if_count;
 
-    ASTNode_copy_code(node, node->conditional.condition);
-    EMIT3OP(CBR, ASTNode_get_temp_reg(node->conditional.condition), 
-            DATA->if_body_label[current_index], 
+    emit_cond_branch(node, node->conditional.condition,
+            DATA->if_body_label[current_index],
             DATA->if_end_label[current_index]);
 
     EMIT1OP(LABEL, DATA->if_body_label[current_index]);
@@ -567,7 +839,7 @@ void CodeGenVisitor_gen_post_location (NodeVisitor* visitor, ASTNode* node)
 {
     // Check if the location is on the left-hand side of an assignment
     // (fixing the register mis count issue)
-    ASTNode *parent = (ASTNode*) ASTNode_get_attribute(node, "parent");
+    ASTNode *parent = node->parent;
     if (parent != NULL && parent->type == ASSIGNMENT) {
         if (parent->assignment.location == node) {
             return;
@@ -582,14 +854,18 @@ void CodeGenVisitor_gen_post_location (NodeVisitor* visitor, ASTNode* node)
 
     // If the variable is an array, handle index calculations
     if (var->symbol_type == ARRAY_SYMBOL) {
-        ASTNode_copy_code(node, node->location.index);
+        ASTNode* index = node->location.index;
 
-        Operand index_reg = ASTNode_get_temp_reg(node->location.index);
-        Operand temp_reg = virtual_register();
-        EMIT3OP(MULT_I, index_reg, int_const(8), temp_reg);
-
-        // Load the value from the calculated offset
-        EMIT3OP(LOAD_AO, base, temp_reg, reg);
+        if (index->type == LITERAL) {
+            // Literal index; fold it into the displacement
+            emit_bounds_check(visitor, node, node, var);
+            EMIT3OP(LOAD_AI, base, int_const(index->literal.integer * WORD_SIZE), reg);
+        } else {
+            // Load the value from base + index * WORD_SIZE
+            ASTNode_copy_code(node, index);
+            emit_bounds_check(visitor, node, node, var);
+            EMIT3OP(LOAD_AS, base, ASTNode_get_temp_reg(index), reg);
+        }
     } else {
         // Handle normal variable loading
         EMIT3OP(LOAD_AI, base, offset, reg);
@@ -624,8 +900,11 @@ void CodeGenVisitor_gen_vardecl(NodeVisitor* visitor, ASTNode* node) {
 #endif
 InsnList* generate_code (ASTNode* tree)
 {
+    return generate_checked_code(tree, false);
+}
 
-
+InsnList* generate_checked_code (ASTNode* tree, bool bounds_check)
+{
     InsnList* iloc = InsnList_new();
     
     // Null check - A Test Case
@@ -636,6 +915,7 @@ InsnList* generate_code (ASTNode* tree)
     NodeVisitor* v = NodeVisitor_new();
     v->data = CodeGenData_new();
     v->dtor = (Destructor)CodeGenData_free;
+    ((CodeGenData*)v->data)->bounds_check = bounds_check;
     v->postvisit_program     = CodeGenVisitor_gen_program;
     v->previsit_funcdecl     = CodeGenVisitor_previsit_funcdecl;
     v->postvisit_funcdecl    = CodeGenVisitor_gen_funcdecl;
@@ -668,7 +948,7 @@ InsnList* generate_code (ASTNode* tree)
 
     /* copy generated code into new list (the AST may be deallocated before
      * the ILOC code is needed) */
-    FOR_EACH(ILOCInsn*, i, (InsnList*)ASTNode_get_attribute(tree, "code")) {
+    FOR_EACH(ILOCInsn*, i, (InsnList*)ASTNode_get_slot(tree, SLOT_CODE)) {
         InsnList_add(iloc, ILOCInsn_copy(i));
     }
     return iloc;
@@ -29,6 +29,7 @@ Symbol* Symbol_new (const char* name, DecafType type)
     CHECK_MALLOC_PTR(symbol)
     symbol->symbol_type = SCALAR_SYMBOL;
     snprintf(symbol->name, MAX_ID_LEN, "%s", name);
+    symbol->key = intern_string(symbol->name);
     symbol->type = type;
     symbol->length = 1;
     symbol->parameters = ParameterList_new();
@@ -44,6 +45,7 @@ Symbol* Symbol_new_array (const char* name, DecafType type, int length)
     CHECK_MALLOC_PTR(symbol)
     symbol->symbol_type = ARRAY_SYMBOL;
     snprintf(symbol->name, MAX_ID_LEN, "%s", name);
+    symbol->key = intern_string(symbol->name);
     symbol->type = type;
     symbol->length = length;
     symbol->parameters = ParameterList_new();
@@ -59,6 +61,7 @@ Symbol* Symbol_new_function (const char* name, DecafType return_type, ParameterL
     CHECK_MALLOC_PTR(symbol)
     symbol->symbol_type = FUNCTION_SYMBOL;
     snprintf(symbol->name, MAX_ID_LEN, "%s", name);
+    symbol->key = intern_string(symbol->name);
     symbol->type = return_type;
     symbol->length = 1;
     symbol->parameters = ParameterList_new();
@@ -128,20 +131,106 @@ SymbolTable* SymbolTable_new_child (SymbolTable* parent)
     return table;
 }
 
+/**
+ * @brief Find the index slot for an interned name (either the slot holding
+ * the symbol with that name or the empty slot where it belongs)
+ */
+Symbol** SymbolTable_find_slot (Symbol** index, int capacity, const char* key)
+{
+    /* interned names are unique pointers, so hash the address (Fibonacci
+     * hashing spreads out the low bits, which are mostly alignment) */
+    size_t i = (size_t)(((uint64_t)(uintptr_t)key * 11400714819323198485ull) >> 32) & (capacity - 1);
+    while (index[i] != NULL && index[i]->key != key) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &index[i];
+}
+
+/**
+ * @brief Add a symbol to a table's hash index (growing it as necessary)
+ */
+void SymbolTable_index_symbol (SymbolTable* table, Symbol* symbol)
+{
+    /* grow when the index would become more than half full */
+    if (2 * (table->num_indexed + 1) > table->index_capacity) {
+        int new_capacity = (table->index_capacity == 0 ? 4 * SYMBOL_TABLE_INDEX_MIN
+                                                       : table->index_capacity * 2);
+        Symbol** new_index = (Symbol**)calloc(new_capacity, sizeof(Symbol*));
+        CHECK_MALLOC_PTR(new_index)
+        for (int i = 0; i < table->index_capacity; i++) {
+            Symbol* old = table->index[i];
+            if (old != NULL) {
+                *SymbolTable_find_slot(new_index, new_capacity, old->key) = old;
+            }
+        }
+        free(table->index);
+        table->index = new_index;
+        table->index_capacity = new_capacity;
+    }
+
+    /* keep the first symbol with each name (same as a linear search) */
+    Symbol** slot = SymbolTable_find_slot(table->index, table->index_capacity, symbol->key);
+    if (*slot == NULL) {
+        *slot = symbol;
+    }
+    table->num_indexed++;
+}
+
+/**
+ * @brief Make sure that a large table's hash index covers all of its symbols
+ *
+ * This normally happens as symbols are inserted; the index is only rebuilt if
+ * symbols were added to @c local_symbols directly.
+ */
+void SymbolTable_update_index (SymbolTable* table)
+{
+    if (table->local_symbols->size <= SYMBOL_TABLE_INDEX_MIN ||
+            table->num_indexed == table->local_symbols->size) {
+        return;
+    }
+    free(table->index);
+    table->index = NULL;
+    table->index_capacity = 0;
+    table->num_indexed = 0;
+    FOR_EACH(Symbol*, sym, table->local_symbols) {
+        SymbolTable_index_symbol(table, sym);
+    }
+}
+
 void SymbolTable_insert (SymbolTable* table, Symbol* symbol)
 {
     SymbolList_add(table->local_symbols, symbol);
+    if (table->index != NULL && table->num_indexed + 1 == table->local_symbols->size) {
+        SymbolTable_index_symbol(table, symbol);
+    } else {
+        SymbolTable_update_index(table);
+    }
 }
 
 Symbol* SymbolTable_lookup (SymbolTable* table, const char* name)
 {
-    FOR_EACH(Symbol*, sym, table->local_symbols) {
-        if (strncmp(name, sym->name, MAX_ID_LEN) == 0) {
-            return sym;
-        }
+    /* look up the interned key once so that each comparison is a pointer
+     * comparison (a name that was never interned cannot be in any table) */
+    char buffer[MAX_ID_LEN];
+    snprintf(buffer, MAX_ID_LEN, "%s", name);
+    const char* key = find_interned_string(buffer);
+    if (key == NULL) {
+        return NULL;
     }
-    if (table->parent != NULL) {
-        return SymbolTable_lookup(table->parent, name);
+    for (; table != NULL; table = table->parent) {
+        SymbolTable_update_index(table);
+        if (table->index != NULL) {
+            Symbol* sym = *SymbolTable_find_slot(table->index, table->index_capacity, key);
+            if (sym != NULL) {
+                return sym;
+            }
+            continue;
+        }
+        FOR_EACH(Symbol*, sym, table->local_symbols) {
+            if (sym->key == key) {
+                return sym;
+            }
+        }
     }
     return NULL;
 }
@@ -149,20 +238,32 @@ Symbol* SymbolTable_lookup (SymbolTable* table, const char* name)
 void SymbolTable_free (SymbolTable* table)
 {
     SymbolList_free(table->local_symbols);
+    free(table->index);
     free(table);
 }
 
 Symbol* lookup_symbol(ASTNode* node, const char* name)
 {
-    /* phase 1: traverse up the tree until we find a symbol table or reach the root */
-    while (node != NULL && !ASTNode_has_attribute(node, "symbolTable")) {
-        node = (ASTNode*)ASTNode_get_attribute(node, "parent");
+    /* phase 0: use the binding recorded by ResolveSymbolsVisitor (if any) */
+    if (node != NULL && node->symbol != NULL && strcmp(node->symbol->name, name) == 0) {
+        return node->symbol;
+    }
+
+    /* phase 1: find the innermost symbol table (recorded in the node by
+     * BuildSymbolTablesVisitor, or else found by traversing up the tree until
+     * we find a symbol table or reach the root) */
+    SymbolTable* table = (node != NULL ? node->scope : NULL);
+    while (table == NULL && node != NULL) {
+        if (ASTNode_has_slot(node, SLOT_SYMBOL_TABLE)) {
+            table = (SymbolTable*)ASTNode_get_slot(node, SLOT_SYMBOL_TABLE);
+        }
+        node = node->parent;
     }
     /* phase 2: if we found a symbol table, look up the symbol in a recursive
      * search managed by @ref SymbolTable_lookup */
     Symbol* symbol = NULL;
-    if (node != NULL) {
-        symbol = SymbolTable_lookup((SymbolTable*)ASTNode_get_attribute(node, "symbolTable"), name);
+    if (table != NULL) {
+        symbol = SymbolTable_lookup(table, name);
     }
     return symbol;
 }
@@ -190,6 +291,7 @@ void BuildSymbolTablesVisitor_previsit_program (NodeVisitor* visitor, ASTNode* n
 
     /* initialize stack */
     visitor->data = table;
+    node->scope = table;
 
     /* add symbols for built-in functions */
     SymbolTable_insert(table, create_print_symbol("print_int",  INT));
@@ -210,6 +312,7 @@ void BuildSymbolTablesVisitor_previsit_funcdecl (NodeVisitor* visitor, ASTNode*
     SymbolTable* table = SymbolTable_new_child((SymbolTable*)visitor->data);
     ASTNode_set_printable_attribute(node, "symbolTable", table, symtable_attr_print, (Destructor)SymbolTable_free);
     visitor->data = table;  /* push onto stack (parent pointer acts as 'next') */
+    node->scope = table;
 
     /* add symbols for parameters (local variables will be handled in vardecl visitor) */
     FOR_EACH (Parameter*, p, node->funcdecl.parameters) {
@@ -227,12 +330,14 @@ void BuildSymbolTablesVisitor_previsit_block (NodeVisitor* visitor, ASTNode* nod
 
     /* push onto stack (parent pointer acts as 'next') */
     visitor->data = table;
+    node->scope = table;
 }
 
 void BuildSymbolTablesVisitor_visit_vardecl (NodeVisitor* visitor, ASTNode* node)
 {
     /* create and add new symbol to the current/top symbol table */
     SymbolTable* current_table = (SymbolTable*) visitor->data;
+    node->scope = current_table;
     Symbol* new_symbol = NULL;
     if (node->vardecl.is_array) {
         new_symbol = Symbol_new_array(node->vardecl.name, node->vardecl.type,
@@ -243,6 +348,12 @@ void BuildSymbolTablesVisitor_visit_vardecl (NodeVisitor* visitor, ASTNode* node
     SymbolTable_insert(current_table, new_symbol);
 }
 
+void BuildSymbolTablesVisitor_previsit_default (NodeVisitor* visitor, ASTNode* node)
+{
+    /* record the current/top symbol table as the node's scope */
+    node->scope = (SymbolTable*)visitor->data;
+}
+
 void BuildSymbolTablesVisitor_postvisit (NodeVisitor* visitor, ASTNode* node)
 {
     visitor->data = ((SymbolTable*)visitor->data)->parent;  /* pop stack */
@@ -255,7 +366,9 @@ NodeVisitor* BuildSymbolTablesVisitor_new (void)
      * the top of a SymbolTable stack; it will allow us to set up the "sheaf"
      * of symbol tables using parent pointers and also we'll always have a
      * readily available reference to the "current" symbol table for adding
-     * new symbols when we get to variable declarations */
+     * new symbols when we get to variable declarations (the top of the stack
+     * is also recorded in every node as its scope) */
+    v->previsit_default   = BuildSymbolTablesVisitor_previsit_default;
     v->previsit_program   = BuildSymbolTablesVisitor_previsit_program;
     v->postvisit_program  = BuildSymbolTablesVisitor_postvisit;
     v->previsit_funcdecl  = BuildSymbolTablesVisitor_previsit_funcdecl;
@@ -266,12 +379,34 @@ NodeVisitor* BuildSymbolTablesVisitor_new (void)
     return v;
 }
 
+/*
+ * Name resolution (AST visitor)
+ */
+
+void ResolveSymbolsVisitor_previsit_location (NodeVisitor* visitor, ASTNode* node)
+{
+    node->symbol = lookup_symbol(node, node->location.name);
+}
+
+void ResolveSymbolsVisitor_previsit_funccall (NodeVisitor* visitor, ASTNode* node)
+{
+    node->symbol = lookup_symbol(node, node->funccall.name);
+}
+
+NodeVisitor* ResolveSymbolsVisitor_new (void)
+{
+    NodeVisitor* v = NodeVisitor_new();
+    v->previsit_location = ResolveSymbolsVisitor_previsit_location;
+    v->previsit_funccall = ResolveSymbolsVisitor_previsit_funccall;
+    return v;
+}
+
 /*
  * SymbolTable debug output (AST visitor)
  */
 
 #define OUTFILE ((FILE*)visitor->data)
-#define PRINT_INDENT    long depth = (long)ASTNode_get_attribute(node, "depth"); \
+#define PRINT_INDENT    long depth = (long)ASTNode_get_slot(node, SLOT_DEPTH); \
                         for (long i = 0; i < depth; i++) { \
                             fprintf(OUTFILE, "  "); \
                         }
@@ -283,10 +418,10 @@ void PrintVisitor_visit_block (NodeVisitor* visitor, ASTNode* node);
 void print_symbol_table (NodeVisitor* visitor, ASTNode* node)
 {
     /* print symbol table if present */
-    if (ASTNode_has_attribute(node, "symbolTable")) {
+    if (ASTNode_has_slot(node, SLOT_SYMBOL_TABLE)) {
         PRINT_INDENT
         fprintf(OUTFILE, "SYM TABLE:\n");
-        SymbolTable* table = (SymbolTable*)ASTNode_get_attribute(node, "symbolTable");
+        SymbolTable* table = (SymbolTable*)ASTNode_get_slot(node, SLOT_SYMBOL_TABLE);
         FOR_EACH(Symbol*, sym, table->local_symbols) {
             PRINT_INDENT
             fprintf(OUTFILE, " ");
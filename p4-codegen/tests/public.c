@@ -313,6 +313,41 @@ TEST_PROGRAM(A_Funcall_ordering, 5,
 
 TEST_PROGRAM(A_Array_sum_and_stuff, 35,
     "int data[5]; def int compute(int x, int y) { return (x*y) + (x-y); } def int main() { int i; int result; i = 0; result = 0; while (i < 5) { data[i] = compute(i, i+1); result = result + data[i]; i = i + 1; } return result; }")
+
+// Test fused compare-and-branch conditions (every comparison operator)
+TEST_MAIN(B_fused_branch_ops, 63,
+    "int r; r = 0; "
+    "if (1 <  2) { r = r + 1; } if (2 <  1) { r = r + 100; } "
+    "if (2 <= 2) { r = r + 2; } if (3 <= 2) { r = r + 100; } "
+    "if (2 == 2) { r = r + 4; } if (2 == 3) { r = r + 100; } "
+    "if (2 >= 2) { r = r + 8; } if (1 >= 2) { r = r + 100; } "
+    "if (3 >  2) { r = r + 16; } if (2 >  2) { r = r + 100; } "
+    "if (2 != 3) { r = r + 32; } if (2 != 2) { r = r + 100; } "
+    "return r;")
+TEST_MAIN(B_fused_branch_while_ne, 7,
+    "int i; i = 0; while (i != 7) { i = i + 1; } return i;")
+
+// Test scaled-index and literal-displacement array addressing
+TEST_PROGRAM(A_Array_literal_and_scaled_index, 6,
+    "int a[4]; def int main() { int i; a[2] = 5; i = 1; a[i] = a[2] + 1; return a[1]; }")
+
+// Test checked mode and redundant bounds check elimination
+TEST_CHECKED_PROGRAM(A_checked_Array_sum_and_stuff, 35,
+    "int data[5]; def int compute(int x, int y) { return (x*y) + (x-y); } def int main() { int i; int result; i = 0; result = 0; while (i < 5) { data[i] = compute(i, i+1); result = result + data[i]; i = i + 1; } return result; }")
+TEST_BOUNDS_CHECKS(A_bounds_literal_in_range, 0,
+    "int a[3]; def int main() { a[0] = 1; a[2] = 2; return a[1]; }")
+TEST_BOUNDS_CHECKS(A_bounds_literal_out_of_range, 2,
+    "int a[3]; def int main() { a[3] = 1; return a[-1]; }")
+TEST_BOUNDS_CHECKS(A_bounds_unknown_index, 2,
+    "int a[3]; def int f(int i) { a[i] = 1; return a[i]; } def int main() { return f(1); }")
+TEST_BOUNDS_CHECKS(A_bounds_loop_induction, 0,
+    "int a[5]; def int main() { int i; int s; i = 0; s = 0; while (i < 5) { a[i] = i; if (a[i] > 2) { s = s + a[i]; } i = i + 1; } return s; }")
+TEST_BOUNDS_CHECKS(A_bounds_loop_after_increment, 1,
+    "int a[5]; def int main() { int i; i = 0; while (i < 5) { i = i + 1; a[i] = i; } return 0; }")
+TEST_BOUNDS_CHECKS(A_bounds_loop_too_long, 1,
+    "int a[5]; def int main() { int i; i = 0; while (i <= 5) { a[i] = i; i = i + 1; } return 0; }")
+TEST_BOUNDS_CHECKS(A_bounds_global_induction, 1,
+    "int a[5]; int i; def int main() { i = 0; while (i < 5) { a[i] = i; i = i + 1; } return 0; }")
 #endif
 
 /**
@@ -429,5 +464,17 @@ void public_tests (Suite *s)
     TEST(A_jumbled_together_stuff);
     TEST(A_Array_sum_and_stuff);
 
+    TEST(B_fused_branch_ops);
+    TEST(B_fused_branch_while_ne);
+    TEST(A_Array_literal_and_scaled_index);
+    TEST(A_checked_Array_sum_and_stuff);
+    TEST(A_bounds_literal_in_range);
+    TEST(A_bounds_literal_out_of_range);
+    TEST(A_bounds_unknown_index);
+    TEST(A_bounds_loop_induction);
+    TEST(A_bounds_loop_after_increment);
+    TEST(A_bounds_loop_too_long);
+    TEST(A_bounds_global_induction);
+
     suite_add_tcase (s, tc);
 }
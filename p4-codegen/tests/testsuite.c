@@ -7,29 +7,63 @@ void Error_throw_printf (const char* format, ...)
     longjmp(decaf_error, 1);
 }
 
-int run_program (char* text)
+InsnList* compile_program (char* text, bool bounds_check)
 {
     ASTNode* tree = NULL;
     if (setjmp(decaf_error) == 0) {
         /* no error */
         tree = parse(lex(text));
     } else {
-        /* parsing error; return code */
-        return ERROR_RETURN_CODE;
+        /* parsing error */
+        return NULL;
     }
     NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
     NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
     NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(ResolveSymbolsVisitor_new(), tree);
     ErrorList* errors = analyze(tree);
     if (!ErrorList_is_empty(errors)) {
-        /* static analysis error; return code */
-        return ERROR_RETURN_CODE;
+        /* static analysis error */
+        return NULL;
     }
     NodeVisitor_traverse_and_free(AllocateSymbolsVisitor_new(), tree);
-    InsnList* iloc = generate_code(tree);
+    return generate_checked_code(tree, bounds_check);
+}
+
+int run_program (char* text)
+{
+    InsnList* iloc = compile_program(text, false);
+    if (iloc == NULL) {
+        return ERROR_RETURN_CODE;
+    }
     return run_simulator(iloc, false);
 }
 
+int run_checked_program (char* text)
+{
+    InsnList* iloc = compile_program(text, true);
+    if (iloc == NULL) {
+        return ERROR_RETURN_CODE;
+    }
+    return run_simulator(iloc, false);
+}
+
+int count_bounds_checks (char* text)
+{
+    InsnList* iloc = compile_program(text, true);
+    if (iloc == NULL) {
+        return ERROR_RETURN_CODE;
+    }
+    int count = 0;
+    FOR_EACH(ILOCInsn*, i, iloc) {
+        if (i->form == BOUNDS) {
+            count++;
+        }
+    }
+    InsnList_free(iloc);
+    return count;
+}
+
 int run_main(char* text)
 {
     char code[MAX_FILE_SIZE+128];
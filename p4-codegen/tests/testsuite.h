@@ -29,6 +29,20 @@
 { ck_assert_int_eq (run_program(TEXT), RVAL); } \
 END_TEST
 
+/**
+ * @brief Define a test case with an entire program compiled with bounds checks
+ */
+#define TEST_CHECKED_PROGRAM(NAME,RVAL,TEXT) START_TEST (NAME) \
+{ ck_assert_int_eq (run_checked_program(TEXT), RVAL); } \
+END_TEST
+
+/**
+ * @brief Define a test case counting the bounds checks emitted for a program
+ */
+#define TEST_BOUNDS_CHECKS(NAME,COUNT,TEXT) START_TEST (NAME) \
+{ ck_assert_int_eq (count_bounds_checks(TEXT), COUNT); } \
+END_TEST
+
 /**
  * @brief Define a test case with only a 'main' function
  */
@@ -63,6 +77,24 @@ END_TEST
  */
 int run_program (char* text);
 
+/**
+ * @brief Run lexer, parser, analysis, and code generation on given program
+ * with bounds checks enabled
+ *
+ * @param text Code to lex, parse, analyze, and generate
+ * @returns Return value or @c ERROR_RETURN_CODE if there was an error
+ */
+int run_checked_program (char* text);
+
+/**
+ * @brief Run lexer, parser, analysis, and checked code generation on given
+ * program and count the emitted bounds checks
+ *
+ * @param text Code to lex, parse, analyze, and generate
+ * @returns Number of @c BOUNDS instructions or @c ERROR_RETURN_CODE if there was an error
+ */
+int count_bounds_checks (char* text);
+
 /**
  * @brief Run lexer, parser, analysis, and code generation on given 'main' function
  *
@@ -199,7 +199,25 @@ typedef enum InsnForm
     CALL,   /**< @brief Call a function (push return address and jump) */
     RETURN, /**< @brief Return from a function (pop return address and jump) */
     PRINT,  /**< @brief Print a constant or register value */
-    PHI     /**< @brief Combine two registers in SSA form */
+    PHI,    /**< @brief Combine two registers in SSA form */
+
+    /* Fused compare-and-branch forms (fall through if the comparison fails) */
+
+    CBR_LT, /**< @brief Compare integers and branch to a target label if true (r1 <  r2 => l1) */
+    CBR_LE, /**< @brief Compare integers and branch to a target label if true (r1 <= r2 => l1) */
+    CBR_EQ, /**< @brief Compare integers and branch to a target label if true (r1 == r2 => l1) */
+    CBR_GE, /**< @brief Compare integers and branch to a target label if true (r1 >= r2 => l1) */
+    CBR_GT, /**< @brief Compare integers and branch to a target label if true (r1 >  r2 => l1) */
+    CBR_NE, /**< @brief Compare integers and branch to a target label if true (r1 != r2 => l1) */
+
+    /* Scaled-index addressing forms */
+
+    LOAD_AS,  /**< @brief Load from memory using address + scaled index (reg + reg * WORD_SIZE) addressing */
+    STORE_AS, /**< @brief Store to memory using address + scaled index (reg + reg * WORD_SIZE) addressing */
+
+    /* Runtime checks */
+
+    BOUNDS    /**< @brief Abort unless a register holds a valid array index (0 <= r1 < c1) */
 
 } InsnForm;
 
@@ -0,0 +1,76 @@
+/**
+ * @file optimize.h
+ * @brief Optional AST and ILOC optimization passes
+ *
+ * These passes are not required for correct code; they are run by the pass
+ * manager (see passes.h) at higher optimization levels. ILOC passes expect
+ * virtual registers and must therefore run before register allocation.
+ */
+
+#ifndef __OPTIMIZE_H
+#define __OPTIMIZE_H
+
+#include "common.h"
+#include "ast.h"
+#include "visitor.h"
+#include "iloc.h"
+
+/**
+ * @brief Fold integer arithmetic on literals into a single literal
+ *
+ * Folds @c +, @c -, @c *, @c / and @c % with two integer literal operands
+ * and negation of an integer literal. Division or modulus by zero and
+ * results that do not fit in an @c int are left alone.
+ *
+ * @param tree Root of AST (modified in place)
+ */
+void fold_constants (ASTNode* tree);
+
+/**
+ * @brief Remove jumps to a label that immediately follows the jump
+ *
+ * @param list ILOC program (modified in place)
+ */
+void remove_redundant_jumps (InsnList* list);
+
+/**
+ * @brief Fuse a comparison and the conditional branch that reads it
+ *
+ * Rewrites "cmp_XX a, b => t; cbr t => l1, l2" into a single fused
+ * compare-and-branch when @c t has no other readers and one of the two
+ * targets immediately follows the branch (so it can be a fall-through).
+ *
+ * @param list ILOC program (modified in place)
+ */
+void fuse_compare_branches (InsnList* list);
+
+/**
+ * @brief Fold a multiply by the word size into scaled-index addressing
+ *
+ * Rewrites "multI i, 8 => t" followed by a single @c LOAD_AO or @c STORE_AO
+ * that uses @c t as its offset into @c LOAD_AS or @c STORE_AS on @c i.
+ *
+ * @param list ILOC program (modified in place)
+ */
+void fold_scaled_index (InsnList* list);
+
+/**
+ * @brief Count the nodes in an AST
+ *
+ * @param tree Root of AST
+ * @returns Number of nodes
+ */
+int count_ast_nodes (ASTNode* tree);
+
+/**
+ * @brief Count the instructions in an ILOC program
+ *
+ * The @c size field of the list is not kept up to date by passes that splice
+ * instructions in directly (e.g., spill code), so this walks the list.
+ *
+ * @param list ILOC program
+ * @returns Number of instructions
+ */
+int count_insns (InsnList* list);
+
+#endif
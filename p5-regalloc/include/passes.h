@@ -0,0 +1,143 @@
+/**
+ * @file passes.h
+ * @brief Pass manager for configurable AST and ILOC pipelines
+ *
+ * A pass manager holds an ordered list of named passes. AST passes run on the
+ * analyzed tree (after symbol allocation and before code generation) and ILOC
+ * passes run on the generated code; consequently, all AST passes in a
+ * pipeline must come before all ILOC passes. The manager records wall time
+ * and size deltas (AST nodes or ILOC instructions) for every pass it runs,
+ * and each pass is also recorded as a phase for -ftime-report (see report.h).
+ */
+
+#ifndef __PASSES_H
+#define __PASSES_H
+
+#include "common.h"
+#include "ast.h"
+#include "iloc.h"
+
+/**
+ * @brief Maximum number of passes in a single pipeline
+ */
+#define MAX_PASSES 32
+
+/**
+ * @brief Number of physical registers targeted by the "regalloc" pass
+ *
+ * The Y86 backend maps R0-R3 to machine registers.
+ */
+#define NUM_PHYSICAL_REGS 4
+
+/**
+ * @brief Pass type
+ */
+typedef enum PassKind
+{
+    AST_PASS,   /**< @brief Runs on the syntax tree */
+    ILOC_PASS   /**< @brief Runs on the generated ILOC code */
+} PassKind;
+
+/**
+ * @brief Single registered pass
+ */
+typedef struct Pass
+{
+    const char* name;                   /**< @brief Name used in @c --passes= lists */
+    PassKind kind;                      /**< @brief Pass type (determines which function is used) */
+    void (*run_ast) (ASTNode* tree);    /**< @brief Entry point for AST passes */
+    void (*run_iloc) (InsnList* list);  /**< @brief Entry point for ILOC passes */
+} Pass;
+
+/**
+ * @brief Statistics recorded for a single pass in a pipeline
+ */
+typedef struct PassStats
+{
+    const Pass* pass;   /**< @brief Pass that was (or will be) run */
+    bool ran;           /**< @brief True once the pass has been run */
+    double seconds;     /**< @brief Wall time spent in the pass */
+    int size_before;    /**< @brief AST node or ILOC instruction count before the pass */
+    int size_after;     /**< @brief AST node or ILOC instruction count after the pass */
+} PassStats;
+
+/**
+ * @brief Ordered pipeline of passes
+ */
+typedef struct PassManager
+{
+    PassStats passes[MAX_PASSES];   /**< @brief Passes in pipeline order */
+    int num_passes;                 /**< @brief Number of passes in the pipeline */
+} PassManager;
+
+/**
+ * @brief Allocate a new, empty pipeline
+ *
+ * @returns Pointer to new pass manager
+ */
+PassManager* PassManager_new (void);
+
+/**
+ * @brief Append a pass to the pipeline by name
+ *
+ * @param pm Pass manager
+ * @param name Registered pass name
+ * @returns False if the name is unknown, the pipeline is full, or an AST
+ * pass would follow an ILOC pass
+ */
+bool PassManager_add (PassManager* pm, const char* name);
+
+/**
+ * @brief Append a comma-separated list of passes (e.g., "fold-constants,regalloc")
+ *
+ * @param pm Pass manager
+ * @param names Comma-separated pass names
+ * @returns False if any pass could not be added (an error is printed to stderr)
+ */
+bool PassManager_add_list (PassManager* pm, const char* names);
+
+/**
+ * @brief Append the passes for an optimization level preset
+ *
+ *   * @c -O0: register allocation only
+ *   * @c -O1: constant folding, redundant jump removal, register allocation
+ *   * @c -O2: @c -O1 plus compare-and-branch fusion and scaled-index folding
+ *
+ * @param pm Pass manager
+ * @param level Optimization level (0-2)
+ * @returns False if the level is unknown
+ */
+bool PassManager_add_preset (PassManager* pm, int level);
+
+/**
+ * @brief Run all AST passes in the pipeline
+ *
+ * @param pm Pass manager
+ * @param tree Root of AST
+ */
+void PassManager_run_ast (PassManager* pm, ASTNode* tree);
+
+/**
+ * @brief Run all ILOC passes in the pipeline
+ *
+ * @param pm Pass manager
+ * @param list ILOC program
+ */
+void PassManager_run_iloc (PassManager* pm, InsnList* list);
+
+/**
+ * @brief Print the recorded time and size delta of every pass that ran
+ *
+ * @param pm Pass manager
+ * @param output File stream to print to
+ */
+void PassManager_print_stats (PassManager* pm, FILE* output);
+
+/**
+ * @brief Deallocate a pass manager
+ *
+ * @param pm Pass manager to deallocate
+ */
+void PassManager_free (PassManager* pm);
+
+#endif
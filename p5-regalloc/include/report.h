@@ -0,0 +1,66 @@
+/**
+ * @file report.h
+ * @brief Per-phase compile time and memory reports (-ftime-report/-fmem-report)
+ *
+ * The compiler driver brackets each phase with @ref Report_begin_phase and
+ * @ref Report_end_phase. Wall and CPU time are always recorded. Memory
+ * statistics are only available when the build defines @c TRACK_ALLOCATIONS
+ * and links with GNU ld's @c --wrap option for @c malloc, @c calloc,
+ * @c realloc, and @c free (see the Makefile); this also counts allocations
+ * made inside the precompiled project objects.
+ */
+
+#ifndef __REPORT_H
+#define __REPORT_H
+
+#include "common.h"
+
+/**
+ * @brief Maximum number of phases that can be recorded
+ */
+#define MAX_PHASES 64
+
+/**
+ * @brief Report output format
+ */
+typedef enum ReportFormat
+{
+    REPORT_TEXT,    /**< @brief Human-readable table */
+    REPORT_JSON     /**< @brief Machine-readable JSON object */
+} ReportFormat;
+
+/**
+ * @brief Get the current wall clock time in seconds
+ */
+double wall_time (void);
+
+/**
+ * @brief Start recording phases (phases are ignored until this is called)
+ */
+void Report_enable (void);
+
+/**
+ * @brief Start recording a phase
+ *
+ * Phases may not be nested; a phase that is still open is ended first.
+ *
+ * @param name Phase name (must remain valid until the report is printed)
+ */
+void Report_begin_phase (const char* name);
+
+/**
+ * @brief Stop recording the current phase
+ */
+void Report_end_phase (void);
+
+/**
+ * @brief Print the recorded phases
+ *
+ * @param output File stream to print to
+ * @param format Output format
+ * @param show_time Include wall and CPU time
+ * @param show_mem Include allocated/peak bytes and allocation counts
+ */
+void Report_print (FILE* output, ReportFormat format, bool show_time, bool show_mem);
+
+#endif
@@ -78,6 +78,12 @@ typedef struct Symbol
      */
     struct Symbol* next;
 
+    /**
+     * @brief Interned copy of @c name (see @ref intern_string) used for
+     * pointer comparisons during lookup
+     */
+    const char* key;
+
 } Symbol;
 
 /**
@@ -137,8 +143,33 @@ typedef struct SymbolTable
      */
     struct SymbolTable* parent;
 
+    /**
+     * @brief Open-addressing hash index of @c local_symbols keyed by interned
+     * name (@c NULL until the table has more than
+     * @ref SYMBOL_TABLE_INDEX_MIN symbols); if a name is declared more than
+     * once, only the first symbol is indexed
+     */
+    Symbol** index;
+
+    /**
+     * @brief Number of slots in @c index (a power of two)
+     */
+    int index_capacity;
+
+    /**
+     * @brief Number of symbols from @c local_symbols that have been added to
+     * @c index (used to detect symbols added directly to the list)
+     */
+    int num_indexed;
+
 } SymbolTable;
 
+/**
+ * @brief Number of symbols a table can hold before it is indexed (smaller
+ * tables are searched linearly, which is faster for a handful of symbols)
+ */
+#define SYMBOL_TABLE_INDEX_MIN 8
+
 /**
  * @brief Create a new symbol table with no parent link
  */
@@ -163,6 +194,8 @@ void SymbolTable_insert (SymbolTable* table, Symbol* symbol);
  * @brief Retrieve a symbol from a table
  * 
  * Looks through parent tables if the symbol is not found in the local table.
+ * Large tables are searched through a hash index; if a name is declared more
+ * than once in a table, the first declaration is returned either way.
  * 
  * @param table Symbol table to search
  * @param name Name of symbol to find
@@ -178,11 +211,14 @@ void SymbolTable_free (SymbolTable* table);
 /**
  * @brief Look up a symbol in an AST
  *
- * The search has two phases: 1) searching AST nodes for a symbol table as a
- * "symbolTable" attribute and following "parent" attributes as necessary
- * (requires the links as set up by a SetParentVisitor), and 2) searching
- * symbol tables for the given symbol name and following parent pointers as
- * necessary.
+ * Locations and function calls that have been bound to a symbol by a
+ * ResolveSymbolsVisitor return that symbol right away (if @p name is the
+ * name that they refer to). Otherwise, the search has two phases: 1) finding the innermost symbol table, which is
+ * recorded in each node's @c scope by a BuildSymbolTablesVisitor (otherwise
+ * the search follows parent links up the tree until it finds a node with a
+ * "symbolTable" attribute, which requires the links as set up by a
+ * SetParentVisitor), and 2) searching symbol tables for the given symbol name
+ * and following parent pointers as necessary.
  *
  * @param node AST node to begin the search at
  * @param name Name of symbol to find
@@ -197,6 +233,20 @@ Symbol* lookup_symbol(ASTNode* node, const char* name);
  */
 NodeVisitor* BuildSymbolTablesVisitor_new (void);
 
+/**
+ * @brief Create a new visitor that binds every location and function call to
+ * the symbol it refers to (see the @c symbol member of @ref ASTNode)
+ *
+ * Names are looked up once here so that later phases can read the binding
+ * instead of searching the symbol tables again. Requires symbol tables (as
+ * built by a BuildSymbolTablesVisitor); the two can be fused into a single
+ * traversal (see @ref FusedVisitor_new) as long as this visitor comes second,
+ * because Decaf declarations always precede the code that uses them.
+ *
+ * @returns Pointer to visitor structure
+ */
+NodeVisitor* ResolveSymbolsVisitor_new (void);
+
 /**
  * @brief Create a new visitor that prints symbol tables
  * 
@@ -38,27 +38,140 @@ const char* NodeType_to_string(NodeType type)
     return "???";
 }
 
+/**
+ * @brief Arena in use (or @c NULL if objects are allocated individually)
+ */
+ASTArena* ast_arena = NULL;
+
+ASTArena* ASTArena_new (void)
+{
+    ASTArena* arena = (ASTArena*)calloc(1, sizeof(ASTArena));
+    CHECK_MALLOC_PTR(arena)
+    return arena;
+}
+
+void ASTArena_use (ASTArena* arena)
+{
+    ast_arena = arena;
+}
+
+void* ASTArena_alloc (ASTArena* arena, size_t size)
+{
+    /* round up so that every allocation is aligned */
+    size = (size + sizeof(max_align_t) - 1) / sizeof(max_align_t) * sizeof(max_align_t);
+
+    /* start a new block if the current one is full (oversized requests get
+     * their own block) */
+    if (arena->blocks == NULL || arena->blocks->used + size > arena->blocks->size) {
+        size_t block_size = (size > AST_ARENA_BLOCK_SIZE ? size : AST_ARENA_BLOCK_SIZE);
+        ASTArenaBlock* block = (ASTArenaBlock*)calloc(1, sizeof(ASTArenaBlock) + block_size);
+        CHECK_MALLOC_PTR(block)
+        block->size = block_size;
+        block->next = arena->blocks;
+        arena->blocks = block;
+        arena->bytes += block_size;
+    }
+    void* ptr = (char*)arena->blocks->data + arena->blocks->used;
+    arena->blocks->used += size;
+    return ptr;
+}
+
+bool ASTArena_owns (ASTArena* arena, void* ptr)
+{
+    if (arena == NULL) {
+        return false;
+    }
+    for (ASTArenaBlock* block = arena->blocks; block != NULL; block = block->next) {
+        char* data = (char*)block->data;
+        if ((char*)ptr >= data && (char*)ptr < data + block->used) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ASTArena_free (ASTArena* arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+
+    /* destructors may free lists that belong to the arena, so it must still
+     * be in use while they run */
+    ASTArena* saved = ast_arena;
+    ast_arena = arena;
+    for (size_t i = 0; i < arena->num_attributes; i++) {
+        Attribute* attr = arena->attributes[i];
+        if (attr->dtor != NULL) {
+            attr->dtor(attr->value);
+        }
+    }
+    ast_arena = (saved == arena ? NULL : saved);
+
+    /* release all blocks at once */
+    ASTArenaBlock* next = arena->blocks;
+    while (next != NULL) {
+        ASTArenaBlock* cur = next;
+        next = cur->next;
+        free(cur);
+    }
+    free(arena->attributes);
+    free(arena);
+}
+
+void* ast_calloc (size_t count, size_t size)
+{
+    if (ast_arena != NULL) {
+        return ASTArena_alloc(ast_arena, count * size);
+    }
+    return calloc(count, size);
+}
+
+void ast_free (void* ptr)
+{
+    if (!ASTArena_owns(ast_arena, ptr)) {
+        free(ptr);
+    }
+}
+
+/**
+ * @brief Store a name in an AST structure (truncated to fit in @c MAX_ID_LEN)
+ *
+ * @param dest Name field to set
+ * @param name Name to store
+ */
+void ASTName_set (ASTName* dest, const char* name)
+{
+#ifdef DECAF_COMPACT_AST
+    char buffer[MAX_ID_LEN];
+    snprintf(buffer, MAX_ID_LEN, "%s", name);
+    *dest = intern_string(buffer);
+#else
+    snprintf(*dest, MAX_ID_LEN, "%s", name);
+#endif
+}
+
 /*
  * use macros defined in common.h to implement lists for nodes and parameters
  */
-DEF_LIST_IMPL(Node, struct ASTNode*, ASTNode_free)
-DEF_LIST_IMPL(Parameter, struct Parameter*, free)
+DEF_LIST_IMPL_ALLOC(Node, struct ASTNode*, ASTNode_free, ast_calloc, ast_free)
+DEF_LIST_IMPL_ALLOC(Parameter, struct Parameter*, ast_free, ast_calloc, ast_free)
 
 /*
  * this custom add-parameter method handles allocation as well
  */
 void ParameterList_add_new (ParameterList* list, const char* name, DecafType type)
 {
-    Parameter* param = (Parameter*)calloc(1, sizeof(Parameter));
+    Parameter* param = (Parameter*)ast_calloc(1, sizeof(Parameter));
     CHECK_MALLOC_PTR(param)
-    snprintf(param->name, MAX_ID_LEN, "%s", name);
+    ASTName_set(&param->name, name);
     param->type = type;
     ParameterList_add(list, param);
 }
 
 ASTNode* ASTNode_new (NodeType type, int source_line)
 {
-    ASTNode* node = (ASTNode*)calloc(1, sizeof(ASTNode));
+    ASTNode* node = (ASTNode*)ast_calloc(1, sizeof(ASTNode));
     CHECK_MALLOC_PTR(node)
     node->type = type;
     node->source_line = source_line;
@@ -67,6 +180,53 @@ ASTNode* ASTNode_new (NodeType type, int source_line)
     return node;
 }
 
+const char* AttributeSlot_to_key (AttributeSlot slot)
+{
+    switch (slot) {
+        case SLOT_PARENT:       return "parent";
+        case SLOT_DEPTH:        return "depth";
+        case SLOT_SYMBOL_TABLE: return "symbolTable";
+        case SLOT_TYPE:         return "type";
+        case SLOT_CODE:         return "code";
+        case SLOT_REG:          return "reg";
+        default:                return "???";
+    }
+}
+
+AttributeSlot AttributeSlot_from_key (const char* key)
+{
+    /* dispatch on the first character so that at most one comparison is needed */
+    AttributeSlot slot;
+    switch (key[0]) {
+        case 'p':   slot = SLOT_PARENT;         break;
+        case 'd':   slot = SLOT_DEPTH;          break;
+        case 's':   slot = SLOT_SYMBOL_TABLE;   break;
+        case 't':   slot = SLOT_TYPE;           break;
+        case 'c':   slot = SLOT_CODE;           break;
+        case 'r':   slot = SLOT_REG;            break;
+        default:    return NO_SLOT;
+    }
+    return (strncmp(key, AttributeSlot_to_key(slot), MAX_ID_LEN) == 0 ? slot : NO_SLOT);
+}
+
+/**
+ * @brief Find an attribute record (in its slot or by searching the list)
+ *
+ * @returns Attribute or @c NULL if the node does not have it
+ */
+Attribute* ASTNode_find_attribute (ASTNode* node, const char* key, AttributeSlot slot)
+{
+    if (slot != NO_SLOT) {
+        return node->slots[slot];
+    }
+    for (Attribute* a = node->attributes; a != NULL; a = a->next) {
+        if (strncmp(key, a->key, MAX_ID_LEN) == 0) {
+            return a;
+        }
+    }
+    return NULL;
+}
+
 void ASTNode_set_attribute (ASTNode* node, const char* key, void* value, Destructor dtor)
 {
     ASTNode_set_printable_attribute(node, key, value, dummy_print, dtor);
@@ -84,36 +244,46 @@ void ASTNode_set_printable_attribute (ASTNode* node, const char* key, void* valu
         Error_throw_printf("ERROR: Tried to set attribute '%s' without a node pointer\n", key);
     }
 
-    /* allocate new attribute */
-    Attribute* attr = (Attribute*)calloc(1, sizeof(Attribute));
+    /* parent links are also stored directly in the node */
+    AttributeSlot slot = AttributeSlot_from_key(key);
+    if (slot == SLOT_PARENT) {
+        node->parent = (ASTNode*)value;
+    }
+
+    /* search existing keys */
+    Attribute* a = ASTNode_find_attribute(node, key, slot);
+    if (a != NULL) {
+
+        /* key present; replace with new value */
+        a->dtor(a->value);
+        a->value = value;
+        a->dtor = dtor;
+        return;
+    }
+
+    /* key not present; allocate new attribute and insert at beginning */
+    Attribute* attr = (Attribute*)ast_calloc(1, sizeof(Attribute));
     CHECK_MALLOC_PTR(attr)
     attr->key = key;
     attr->value = value;
     attr->dot_printer = dot_printer;
     attr->dtor = dtor;
-    attr->next = NULL;
-
-    if (node->attributes == NULL) {
-        /* first attribute */
-        node->attributes = attr;
-    } else {
-
-        /* search existing keys */
-        for (Attribute* a = node->attributes; a != NULL; a = a->next) {
-            if (strncmp(key, a->key, MAX_ID_LEN) == 0) {
-
-                /* key present; replace with new value */
-                a->dtor(a->value);
-                a->value = value;
-                a->dtor = dtor;
-                free(attr);
-                return;
-            }
-        }
+    attr->next = node->attributes;
+    node->attributes = attr;
+    if (slot != NO_SLOT) {
+        node->slots[slot] = attr;
+    }
 
-        /* key not present; insert at beginning */
-        attr->next = node->attributes;
-        node->attributes = attr;
+    /* the arena runs the destructor when it is freed */
+    if (ast_arena != NULL) {
+        ASTArena* arena = ast_arena;
+        if (arena->num_attributes == arena->attribute_capacity) {
+            arena->attribute_capacity = (arena->attribute_capacity == 0 ? 256 : arena->attribute_capacity * 2);
+            arena->attributes = (Attribute**)realloc(arena->attributes,
+                    arena->attribute_capacity * sizeof(Attribute*));
+            CHECK_MALLOC_PTR(arena->attributes)
+        }
+        arena->attributes[arena->num_attributes++] = attr;
     }
 }
 
@@ -122,12 +292,7 @@ bool ASTNode_has_attribute (ASTNode* node, const char* key)
     if (node == NULL) {
         Error_throw_printf("ERROR: Tried to get attribute '%s' without a node pointer\n", key);
     }
-    for (Attribute* a = node->attributes; a != NULL; a = a->next) {
-        if (strncmp(key, a->key, MAX_ID_LEN) == 0) {
-            return true;
-        }
-    }
-    return false;
+    return ASTNode_find_attribute(node, key, AttributeSlot_from_key(key)) != NULL;
 }
 
 int ASTNode_get_int_attribute (ASTNode* node, const char* key)
@@ -140,83 +305,142 @@ void* ASTNode_get_attribute (ASTNode* node, const char* key)
     if (node == NULL) {
         Error_throw_printf("ERROR: Tried to get attribute '%s' without a node pointer\n", key);
     }
-    for (Attribute* a = node->attributes; a != NULL; a = a->next) {
-        if (strncmp(key, a->key, MAX_ID_LEN) == 0) {
-            return a->value;
-        }
+    Attribute* a = ASTNode_find_attribute(node, key, AttributeSlot_from_key(key));
+    if (a == NULL) {
+        printf("ERROR: No '%s' attribute\n", key);
+        return NULL;
     }
-    printf("ERROR: No '%s' attribute\n", key);
-    return NULL;
+    return a->value;
 }
 
+bool ASTNode_has_slot (ASTNode* node, AttributeSlot slot)
+{
+    if (node == NULL) {
+        Error_throw_printf("ERROR: Tried to get attribute '%s' without a node pointer\n",
+                AttributeSlot_to_key(slot));
+    }
+    return slot < NUM_ATTRIBUTE_SLOTS && node->slots[slot] != NULL;
+}
+
+void* ASTNode_get_slot (ASTNode* node, AttributeSlot slot)
+{
+    if (node == NULL) {
+        Error_throw_printf("ERROR: Tried to get attribute '%s' without a node pointer\n",
+                AttributeSlot_to_key(slot));
+    }
+    Attribute* a = (slot < NUM_ATTRIBUTE_SLOTS ? node->slots[slot] : NULL);
+    if (a == NULL) {
+        printf("ERROR: No '%s' attribute\n", AttributeSlot_to_key(slot));
+        return NULL;
+    }
+    return a->value;
+}
+
+/**
+ * @brief Add a detached child to the front of a list of nodes waiting to be
+ * freed (linked through their @c next pointers)
+ */
+#define PEND_CHILD(CHILD) if ((CHILD) != NULL) { (CHILD)->next = pending; pending = (CHILD); }
+
+/**
+ * @brief Add every node in a list to the front of a list of nodes waiting to
+ * be freed and deallocate the list structure
+ */
+#define PEND_LIST(LIST) if ((LIST)->head != NULL) { (LIST)->tail->next = pending; pending = (LIST)->head; } \
+                        ast_free(LIST);
+
 void ASTNode_free (ASTNode* node)
 {
-    /* clean up attributes */
-    Attribute* next = node->attributes;
-    while (next != NULL) {
-        Attribute* cur = next;
-        next = cur->next;
-        if (cur->dtor != NULL) {
-            cur->dtor(cur->value);
+    /*
+     * Free the tree without recursion (so that very deep trees cannot
+     * overflow the C stack): the children of each freed node are spliced
+     * onto a list of pending nodes. List children are already linked through
+     * their next pointers and single children are not in any list, so this
+     * needs no extra memory. The root's own next pointer is never followed
+     * because it may belong to a list that the caller is freeing.
+     */
+    ASTNode* pending = NULL;
+    while (node != NULL) {
+
+        /* nodes in the arena are released all at once by ASTArena_free */
+        if (ASTArena_owns(ast_arena, node)) {
+            node = pending;
+            pending = (node != NULL ? node->next : NULL);
+            continue;
         }
-        free(cur);
-    }
 
-    /* clean up node-specific data */
-    switch (node->type) {
-        case PROGRAM:
-            NodeList_free(node->program.variables);
-            NodeList_free(node->program.functions);
-            break;
-        case FUNCDECL:
-            ParameterList_free(node->funcdecl.parameters);
-            ASTNode_free(node->funcdecl.body);
-            break;
-        case BLOCK:
-            NodeList_free(node->block.variables);
-            NodeList_free(node->block.statements);
-            break;
-        case ASSIGNMENT:
-            ASTNode_free(node->assignment.location);
-            ASTNode_free(node->assignment.value);
-            break;
-        case CONDITIONAL:
-            ASTNode_free(node->conditional.condition);
-            ASTNode_free(node->conditional.if_block);
-            if (node->conditional.else_block != NULL) {
-                ASTNode_free(node->conditional.else_block);
-            }
-            break;
-        case WHILELOOP:
-            ASTNode_free(node->whileloop.condition);
-            ASTNode_free(node->whileloop.body);
-            break;
-        case RETURNSTMT:
-            if (node->funcreturn.value != NULL) {
-                ASTNode_free(node->funcreturn.value);
-            }
-            break;
-        case BINARYOP:
-            ASTNode_free(node->binaryop.left);
-            ASTNode_free(node->binaryop.right);
-            break;
-        case UNARYOP:
-            ASTNode_free(node->unaryop.child);
-            break;
-        case LOCATION:
-            if (node->location.index != NULL) {
-                ASTNode_free(node->location.index);
+        /* clean up attributes (clearing the destructor in case the attribute
+         * belongs to the arena, which would otherwise run it again) */
+        Attribute* next = node->attributes;
+        while (next != NULL) {
+            Attribute* cur = next;
+            next = cur->next;
+            if (cur->dtor != NULL) {
+                cur->dtor(cur->value);
+                cur->dtor = NULL;
             }
-            break;
-        case FUNCCALL:
-            NodeList_free(node->funccall.arguments);
-            break;
-        default:
-            break;
-    }
+            ast_free(cur);
+        }
+
+        /* clean up node-specific data and queue up children */
+        switch (node->type) {
+            case PROGRAM:
+                PEND_LIST(node->program.variables)
+                PEND_LIST(node->program.functions)
+                break;
+            case FUNCDECL:
+                ParameterList_free(node->funcdecl.parameters);
+                PEND_CHILD(node->funcdecl.body)
+                break;
+            case BLOCK:
+                PEND_LIST(node->block.variables)
+                PEND_LIST(node->block.statements)
+                break;
+            case ASSIGNMENT:
+                PEND_CHILD(node->assignment.location)
+                PEND_CHILD(node->assignment.value)
+                break;
+            case CONDITIONAL:
+                PEND_CHILD(node->conditional.condition)
+                PEND_CHILD(node->conditional.if_block)
+                PEND_CHILD(node->conditional.else_block)
+                break;
+            case WHILELOOP:
+                PEND_CHILD(node->whileloop.condition)
+                PEND_CHILD(node->whileloop.body)
+                break;
+            case RETURNSTMT:
+                PEND_CHILD(node->funcreturn.value)
+                break;
+            case BINARYOP:
+                PEND_CHILD(node->binaryop.left)
+                PEND_CHILD(node->binaryop.right)
+                break;
+            case UNARYOP:
+                PEND_CHILD(node->unaryop.child)
+                break;
+            case LOCATION:
+                PEND_CHILD(node->location.index)
+                break;
+            case FUNCCALL:
+                PEND_LIST(node->funccall.arguments)
+                break;
+#ifdef DECAF_COMPACT_AST
+            case LITERAL:
+                if (node->literal.type == STR) {
+                    ast_free(node->literal.string);
+                }
+                break;
+#endif
+            default:
+                break;
+        }
 
-    /* clean up node itself */
-    free(node);
+        /* clean up node itself and move on to the next pending node */
+        ast_free(node);
+        node = pending;
+        pending = (node != NULL ? node->next : NULL);
+    }
 }
 
 ASTNode* ProgramNode_new (NodeList* vars, NodeList* funcs)
@@ -230,7 +454,7 @@ ASTNode* ProgramNode_new (NodeList* vars, NodeList* funcs)
 ASTNode* VarDeclNode_new (const char* name, DecafType type, bool is_array, int array_length, int source_line)
 {
     ASTNode* node = ASTNode_new(VARDECL, source_line);
-    snprintf(node->vardecl.name, MAX_ID_LEN, "%s", name);
+    ASTName_set(&node->vardecl.name, name);
     node->vardecl.type = type;
     node->vardecl.is_array = is_array;
     node->vardecl.array_length = array_length;
@@ -240,7 +464,7 @@ ASTNode* VarDeclNode_new (const char* name, DecafType type, bool is_array, int a
 ASTNode* FuncDeclNode_new (const char* name, DecafType return_type, ParameterList* parameters, ASTNode* body, int source_line)
 {
     ASTNode* node = ASTNode_new(FUNCDECL, source_line);
-    snprintf(node->funcdecl.name, MAX_ID_LEN, "%s", name);
+    ASTName_set(&node->funcdecl.name, name);
     node->funcdecl.return_type = return_type;
     node->funcdecl.parameters = parameters;
     node->funcdecl.body = body;
@@ -346,7 +570,7 @@ ASTNode* UnaryOpNode_new (UnaryOpType operator, struct ASTNode* child, int sourc
 ASTNode* LocationNode_new (const char* name, struct ASTNode* index, int source_line)
 {
     ASTNode* node = ASTNode_new(LOCATION, source_line);
-    snprintf(node->location.name, MAX_ID_LEN, "%s", name);
+    ASTName_set(&node->location.name, name);
     node->location.index = index;
     return node;
 }
@@ -354,7 +578,7 @@ ASTNode* LocationNode_new (const char* name, struct ASTNode* index, int source_l
 ASTNode* FuncCallNode_new (const char* name, NodeList* args, int source_line)
 {
     ASTNode* node = ASTNode_new(FUNCCALL, source_line);
-    snprintf(node->funccall.name, MAX_ID_LEN, "%s", name);
+    ASTName_set(&node->funccall.name, name);
     node->funccall.arguments = args;
     return node;
 }
@@ -379,6 +603,16 @@ ASTNode* LiteralNode_new_string (const char* value, int source_line)
 {
     ASTNode* node = ASTNode_new(LITERAL, source_line);
     node->literal.type = STR;
+#ifdef DECAF_COMPACT_AST
+    size_t length = strlen(value);
+    if (length > MAX_LINE_LEN - 1) {
+        length = MAX_LINE_LEN - 1;
+    }
+    node->literal.string = (char*)ast_calloc(length + 1, sizeof(char));
+    CHECK_MALLOC_PTR(node->literal.string)
+    memcpy(node->literal.string, value, length);
+#else
     snprintf(node->literal.string, MAX_LINE_LEN, "%s", value);
+#endif
     return node;
 }
@@ -143,6 +143,7 @@ ILOCInsn* ILOCInsn_copy (ILOCInsn* insn)
 #define PRINT(S) fprintf(output, S)
 #define PRINTOP(I) Operand_print(insn->op[I], output)
 #define PRINTPLUS(I) fprintf(output, "%s", (insn->op[I].imm >= 0 ? "+" : ""))
+#define PRINTSCALE fprintf(output, "*%d", WORD_SIZE)
 
 void ILOCInsn_print (ILOCInsn* insn, FILE* output)
 {
@@ -168,6 +169,8 @@ void ILOCInsn_print (ILOCInsn* insn, FILE* output)
         case STORE:     PRINT("store ");   PRINTOP(0); PRINT(" => ["); PRINTOP(1); PRINT("]");                             break;
         case STORE_AI:  PRINT("storeAI "); PRINTOP(0); PRINT(" => ["); PRINTOP(1); PRINTPLUS(2);   PRINTOP(2); PRINT("]"); break;
         case STORE_AO:  PRINT("storeAO "); PRINTOP(0); PRINT(" => ["); PRINTOP(1); PRINTPLUS(2);   PRINTOP(2); PRINT("]"); break;
+        case LOAD_AS:   PRINT("loadAS ["); PRINTOP(0); PRINT("+");     PRINTOP(1); PRINTSCALE; PRINT("] => "); PRINTOP(2); break;
+        case STORE_AS:  PRINT("storeAS "); PRINTOP(0); PRINT(" => ["); PRINTOP(1); PRINT("+");     PRINTOP(2); PRINTSCALE; PRINT("]"); break;
         case I2I:       PRINT("i2i ");     PRINTOP(0); PRINT(" => ");  PRINTOP(1);                                         break;
         case PUSH:      PRINT("push ");    PRINTOP(0);                                                                     break;
         case POP:       PRINT("pop ");     PRINTOP(0);                                                                     break;
@@ -180,6 +183,14 @@ void ILOCInsn_print (ILOCInsn* insn, FILE* output)
         case CBR:       PRINT("cbr ");   PRINTOP(0); PRINT(" => "); PRINTOP(1); PRINT(", ");   PRINTOP(2); break;
         case PHI:       PRINT("phi ");   PRINTOP(0); PRINT(", ");   PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
 
+        /* fused compare-and-branch */
+        case CBR_LT:    PRINT("cbr_LT "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+        case CBR_LE:    PRINT("cbr_LE "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+        case CBR_EQ:    PRINT("cbr_EQ "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+        case CBR_GE:    PRINT("cbr_GE "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+        case CBR_GT:    PRINT("cbr_GT "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+        case CBR_NE:    PRINT("cbr_NE "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
+
         /* comparison */
         case CMP_LT:    PRINT("cmp_LT "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
         case CMP_LE:    PRINT("cmp_LE "); PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(" => "); PRINTOP(2); break;
@@ -191,6 +202,7 @@ void ILOCInsn_print (ILOCInsn* insn, FILE* output)
         /* misc */
         case NOP:       PRINT("nop"); break;
         case PRINT:     PRINT("print "); PRINTOP(0); break;
+        case BOUNDS:    PRINT("bounds "); PRINTOP(0); PRINT(", "); PRINTOP(1); break;
 
         /* unknown */
         default:        PRINT("??? ");    PRINTOP(0); PRINT(", "); PRINTOP(1); PRINT(", ");   PRINTOP(2); break;
@@ -213,7 +225,7 @@ ILOCInsn* ILOCInsn_get_read_registers (ILOCInsn* insn)
     ILOCInsn* ret = ILOCInsn_new_0op(NOP);
     switch (insn->form)
     {
-        case STORE_AO:
+        case STORE_AO: case STORE_AS:
             ret->op[0] = insn->op[0];
             ret->op[1] = insn->op[1];
             ret->op[2] = insn->op[2];
@@ -221,7 +233,8 @@ ILOCInsn* ILOCInsn_get_read_registers (ILOCInsn* insn)
 
         case ADD: case SUB: case MULT: case DIV: case AND: case OR:
         case CMP_LT: case CMP_LE: case CMP_EQ: case CMP_NE: case CMP_GE: case CMP_GT:
-        case LOAD_AO: case STORE: case STORE_AI:
+        case CBR_LT: case CBR_LE: case CBR_EQ: case CBR_NE: case CBR_GE: case CBR_GT:
+        case LOAD_AO: case LOAD_AS: case STORE: case STORE_AI:
         case PHI:
             ret->op[0] = insn->op[0];
             ret->op[1] = insn->op[1];
@@ -230,7 +243,7 @@ ILOCInsn* ILOCInsn_get_read_registers (ILOCInsn* insn)
         case ADD_I: case MULT_I:
         case LOAD: case LOAD_AI: case I2I:
         case CBR: case NOT: case NEG: case PUSH:
-        case PRINT:
+        case PRINT: case BOUNDS:
             if (insn->op[0].type == VIRTUAL_REG ||
                 insn->op[0].type == PHYSICAL_REG ||
                 insn->op[0].type == STACK_REG ||
@@ -254,7 +267,7 @@ Operand ILOCInsn_get_write_register (ILOCInsn* insn)
         case ADD: case SUB: case MULT: case DIV: case AND: case OR:
         case CMP_LT: case CMP_LE: case CMP_EQ: case CMP_NE: case CMP_GE: case CMP_GT:
         case ADD_I: case MULT_I:
-        case LOAD_AI: case LOAD_AO:
+        case LOAD_AI: case LOAD_AO: case LOAD_AS:
         case PHI:
             return insn->op[2];
 
@@ -414,19 +427,19 @@ void insnlist_attr_print (InsnList* list, FILE* output)
 void ASTNode_copy_code (ASTNode* dest, ASTNode* src)
 {
     /* ensure there's a code attribute in the destination (create if absent) */
-    if (!ASTNode_has_attribute(dest, "code")) {
+    if (!ASTNode_has_slot(dest, SLOT_CODE)) {
         ASTNode_set_printable_attribute(dest, "code", InsnList_new(),
                 (AttributeValueDOTPrinter)insnlist_attr_print, (Destructor)InsnList_free);
     }
 
     /* make sure there's actually something to copy */
-    if (!ASTNode_has_attribute(src, "code")) {
+    if (!ASTNode_has_slot(src, SLOT_CODE)) {
         return;
     }
 
     /* copy each instruction */
-    InsnList* src_list  = ASTNode_get_attribute(src,  "code");
-    InsnList* dest_list = ASTNode_get_attribute(dest, "code");
+    InsnList* src_list  = ASTNode_get_slot(src, SLOT_CODE);
+    InsnList* dest_list = ASTNode_get_slot(dest, SLOT_CODE);
     FOR_EACH(ILOCInsn*, i, src_list) {
         InsnList_add(dest_list, ILOCInsn_copy(i));
     }
@@ -434,20 +447,20 @@ void ASTNode_copy_code (ASTNode* dest, ASTNode* src)
 
 void ASTNode_emit_insn (ASTNode* dest, ILOCInsn* insn)
 {
-    if (!ASTNode_has_attribute(dest, "code")) {
-        ASTNode_set_printable_attribute(dest, "code", (void*)NodeList_new(),
+    if (!ASTNode_has_slot(dest, SLOT_CODE)) {
+        ASTNode_set_printable_attribute(dest, "code", (void*)InsnList_new(),
                 (AttributeValueDOTPrinter)insnlist_attr_print, (Destructor)InsnList_free);
     }
-    InsnList* list = ASTNode_get_attribute(dest, "code");
+    InsnList* list = ASTNode_get_slot(dest, SLOT_CODE);
     InsnList_add(list, insn);
 }
 
 void ASTNode_add_comment (ASTNode* dest, const char* comment)
 {
-    if (!ASTNode_has_attribute(dest, "code")) {
+    if (!ASTNode_has_slot(dest, SLOT_CODE)) {
         return;
     }
-    InsnList* list = ASTNode_get_attribute(dest, "code");
+    InsnList* list = ASTNode_get_slot(dest, SLOT_CODE);
     if (InsnList_is_empty(list)) {
         return;
     }
@@ -463,11 +476,11 @@ void ASTNode_set_temp_reg (ASTNode* node, Operand reg)
 Operand ASTNode_get_temp_reg (ASTNode* node)
 {
     Operand op = { .type = VIRTUAL_REG, .id = -1 };
-    if (!ASTNode_has_attribute(node, "reg")) {
+    if (!ASTNode_has_slot(node, SLOT_REG)) {
         printf("ERROR: Node is missing a temporary register");
         return op;
     }
-    op.id = (int)(long)ASTNode_get_attribute(node, "reg");
+    op.id = (int)(long)ASTNode_get_slot(node, SLOT_REG);
     return op;
 }
 
@@ -496,9 +509,9 @@ typedef uint8_t byte_t;
 typedef struct CallTarget
 {
     /**
-     * @brief Function name
+     * @brief Function name (interned; see @ref intern_string)
      */
-    char name[MAX_TOKEN_LEN];
+    const char* name;
 
     /**
      * @brief Pointer to corresponding label "instruction"
@@ -519,15 +532,16 @@ void CallTargetList_add_new (CallTargetList* list, const char* name, ILOCInsn* t
 {
     CallTarget* new_target = (CallTarget*)calloc(1, sizeof(CallTarget));
     CHECK_MALLOC_PTR(new_target);
-    snprintf(new_target->name, MAX_TOKEN_LEN, "%s", name);
+    new_target->name = intern_string(name);
     new_target->insn = target;
     CallTargetList_add(list, new_target);
 }
 
 ILOCInsn* CallTargetList_find (CallTargetList* list, const char* name)
 {
+    const char* key = intern_string(name);
     FOR_EACH (CallTarget*, target, list) {
-        if (token_str_eq(target->name, name)) {
+        if (target->name == key) {
             return target->insn;
         }
     }
@@ -825,10 +839,19 @@ void assert_valid_insn (ILOCInsn* insn)
         case CMP_NE:
         case LOAD_AO:
         case STORE_AO:
+        case LOAD_AS:
+        case STORE_AS:
         case PHI:
             assert_all_register_operands(insn, 3);
             break;
 
+        /* reg, int */
+        case BOUNDS:
+            assert_operand_count(insn, 2);
+            assert_operand_is_register(insn, insn->op[0]);
+            assert_operand_type(insn, insn->op[1], INT_CONST);
+            break;
+
         /* int, reg */
         case LOAD_I:
             assert_operand_count(insn, 2);
@@ -872,6 +895,19 @@ void assert_valid_insn (ILOCInsn* insn)
             assert_operand_type(insn, insn->op[2], JUMP_LABEL);
             break;
 
+        /* reg, reg, lbl */
+        case CBR_LT:
+        case CBR_LE:
+        case CBR_EQ:
+        case CBR_GE:
+        case CBR_GT:
+        case CBR_NE:
+            assert_operand_count(insn, 3);
+            assert_operand_is_register(insn, insn->op[0]);
+            assert_operand_is_register(insn, insn->op[1]);
+            assert_operand_type(insn, insn->op[2], JUMP_LABEL);
+            break;
+
         /* lbl */
         case LABEL:
             assert_operand_count(insn, 1);
@@ -946,6 +982,10 @@ void assert_valid_insn (ILOCInsn* insn)
                     *(LOC) = ILOCMachine_get_mem(machine, machine->sp); \
                     machine->sp += WORD_SIZE;
 
+#define BRANCH_IF(COND) if (COND) { \
+                            next_insn = machine->jump_targets[OP2.id]->next; \
+                        }
+
 #define TIMEOUT_NUM_INSTRUCTIONS 100000000
 
 int run_simulator (InsnList* program, bool print_trace)
@@ -999,6 +1039,8 @@ int run_simulator (InsnList* program, bool print_trace)
             case STORE:    SET_MEM(GET_REG(OP1),                GET_REG(OP0)); break;
             case STORE_AI: SET_MEM(GET_REG(OP1) + IMMOP2,       GET_REG(OP0)); break;
             case STORE_AO: SET_MEM(GET_REG(OP1) + GET_REG(OP2), GET_REG(OP0)); break;
+            case LOAD_AS:  SET_REG(OP2, GET_MEM(GET_REG(OP0) + GET_REG(OP1) * WORD_SIZE)); break;
+            case STORE_AS: SET_MEM(GET_REG(OP1) + GET_REG(OP2) * WORD_SIZE, GET_REG(OP0)); break;
 
             case ADD:    SET_REG(OP2, GET_REG(OP0) +  GET_REG(OP1)); break;
             case SUB:    SET_REG(OP2, GET_REG(OP0) -  GET_REG(OP1)); break;
@@ -1044,6 +1086,13 @@ int run_simulator (InsnList* program, bool print_trace)
                 }
                 break;
 
+            case CBR_LT: BRANCH_IF(GET_REG(OP0) <  GET_REG(OP1)); break;
+            case CBR_LE: BRANCH_IF(GET_REG(OP0) <= GET_REG(OP1)); break;
+            case CBR_EQ: BRANCH_IF(GET_REG(OP0) == GET_REG(OP1)); break;
+            case CBR_NE: BRANCH_IF(GET_REG(OP0) != GET_REG(OP1)); break;
+            case CBR_GE: BRANCH_IF(GET_REG(OP0) >= GET_REG(OP1)); break;
+            case CBR_GT: BRANCH_IF(GET_REG(OP0) >  GET_REG(OP1)); break;
+
             case CALL:
             {
                 /* calculate index of next instruction */
@@ -1079,6 +1128,14 @@ int run_simulator (InsnList* program, bool print_trace)
                 }
                 break;
 
+            case BOUNDS:
+                if (GET_REG(OP0) < 0 || GET_REG(OP0) >= IMMOP1) {
+                    printf("ERROR: Array index " PRIW " out of bounds (length %ld)\n",
+                            GET_REG(OP0), IMMOP1);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+
             case LABEL:
             case NOP:
             case PHI:
@@ -8,6 +8,8 @@
 #include "p3-analysis.h"
 #include "p4-codegen.h"
 #include "p5-regalloc.h"
+#include "passes.h"
+#include "report.h"
 
 #include "y86.h"
 
@@ -40,28 +42,15 @@ void Error_throw_printf (const char* format, ...)
 }
 
 /**
- * @brief Read all text data from a file
+ * @brief Print usage information
  *
- * @param filename Name of file to read
- * @param text String buffer destination (must be #MAX_FILE_SIZE characters long)
- * @returns True if and only if the file read was successful.
+ * @param program Executable name
  */
-bool read_file (const char* filename, char* text)
+void print_usage (const char* program)
 {
-    FILE* input = fopen(filename, "r");
-    if (input == NULL) {
-        return false;
-    }
-    size_t nchars = 0;
-    char* p = text;
-    int c;
-    while (nchars < MAX_FILE_SIZE && (c = fgetc(input)) != EOF) {
-        *p++ = (char)c;
-        nchars++;
-    }
-    *p = '\0';
-    fclose(input);
-    return true;
+    fprintf(stderr, "Usage: %s [-O0|-O1|-O2] [--passes=<pass>,...] [--pass-stats]\n"
+                    "       [-ftime-report] [-fmem-report] [-freport-format=text|json] <decaf-filename>\n",
+            program);
 }
 
 /**
@@ -74,20 +63,63 @@ bool read_file (const char* filename, char* text)
  */
 int main(int argc, char** argv)
 {
-    /* check for filename */
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <decaf-filename>\n", argv[0]);
+    /* check for options and filename */
+    if (argc < 2) {
+        print_usage(argv[0]);
         return EXIT_FAILURE;
     }
+    int opt_level = 0;
+    const char* pass_list = NULL;
+    bool print_pass_stats = false;
+    bool time_report = false;
+    bool mem_report = false;
+    ReportFormat report_format = REPORT_TEXT;
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0 ||
+            strcmp(argv[i], "-O2") == 0) {
+            opt_level = argv[i][2] - '0';
+        } else if (strncmp(argv[i], "--passes=", 9) == 0) {
+            pass_list = argv[i] + 9;
+        } else if (strcmp(argv[i], "--pass-stats") == 0) {
+            print_pass_stats = true;
+        } else if (strcmp(argv[i], "-ftime-report") == 0) {
+            time_report = true;
+        } else if (strcmp(argv[i], "-fmem-report") == 0) {
+            mem_report = true;
+        } else if (strcmp(argv[i], "-freport-format=text") == 0) {
+            report_format = REPORT_TEXT;
+        } else if (strcmp(argv[i], "-freport-format=json") == 0) {
+            report_format = REPORT_JSON;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
     char* filename = argv[argc-1];
+    if (time_report || mem_report) {
+        Report_enable();
+    }
+
+    /* set up optimization pipeline (a custom pass list overrides -O) */
+    PassManager* passes = PassManager_new();
+    if (!(pass_list != NULL ? PassManager_add_list(passes, pass_list)
+                            : PassManager_add_preset(passes, opt_level))) {
+        PassManager_free(passes);
+        return EXIT_FAILURE;
+    }
 
     /* read file */
-    char text[MAX_FILE_SIZE];
-    if (!read_file(filename, text)) {
+    SourceText* source = SourceText_read(filename);
+    if (source == NULL) {
         fprintf(stderr, "Could not read file: %s", filename);
         exit(EXIT_FAILURE);
     }
 
+    /* allocate the AST in an arena (set DECAF_NO_ARENA in the environment to
+     * allocate each object individually, e.g., for valgrind) */
+    ASTArena* arena = (getenv("DECAF_NO_ARENA") == NULL ? ASTArena_new() : NULL);
+    ASTArena_use(arena);
+
     /* FRONT END */
 
     TokenQueue* tokens = NULL;
@@ -97,35 +129,47 @@ int main(int argc, char** argv)
     if (setjmp(decaf_error) == 0) {
 
         /* PROJECT 1: lexer */
-        tokens = lex(text);
+        Report_begin_phase("lex");
+        tokens = lex(source->text);
+
+        /* clean up source text (tokens hold copies of their text) */
+        SourceText_free(source);
+        source = NULL;
 
         /* PROJECT 2: parser */
+        Report_begin_phase("parse");
         tree = parse(tokens);
 
         /* clean up tokens (no longer needed) */
         TokenQueue_free(tokens);
         tokens = NULL;
+        Report_end_phase();
 
     } else {
 
         /* handle fatal error: print message and clean up */
         fprintf(stderr, "%s", decaf_error_msg);
+        if (source   != NULL) SourceText_free(source);
         if (tokens   != NULL) TokenQueue_free(tokens);
         if (tree     != NULL) ASTNode_free(tree);
+        ASTArena_free(arena);
+        PassManager_free(passes);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
-    /* set up parent links and calculate node depths */
-    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
-    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
-
-    /* MIDDLE END */
-
-    /* build symbol tables */
-    NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    /* set up parent links, calculate node depths, and (MIDDLE END) build
+     * symbol tables and bind each name to its symbol, all in a single
+     * traversal */
+    Report_begin_phase("setup-tree");
+    NodeVisitor_traverse_and_free(FusedVisitor_new(4,
+            SetParentVisitor_new(), CalcDepthVisitor_new(),
+            BuildSymbolTablesVisitor_new(), ResolveSymbolsVisitor_new()), tree);
 
     /* PROJECT 3: analysis */
+    Report_begin_phase("analyze");
     ErrorList* errors = analyze(tree);
+    Report_end_phase();
 
     /* print analysis errors */
     FOR_EACH(AnalysisError*, err, errors) {
@@ -135,7 +179,10 @@ int main(int argc, char** argv)
     /* abort if analysis has reported errors */
     if (!ErrorList_is_empty(errors)) {
         ASTNode_free(tree);
+        ASTArena_free(arena);
         ErrorList_free(errors);
+        PassManager_free(passes);
+        free_interned_strings();
         exit(EXIT_FAILURE);
     }
 
@@ -146,23 +193,38 @@ int main(int argc, char** argv)
     /* BACK END */
 
     /* run symbol allocation */
+    Report_begin_phase("allocate-symbols");
     NodeVisitor_traverse_and_free(AllocateSymbolsVisitor_new(), tree);
+    Report_end_phase();
+
+    /* run AST passes */
+    PassManager_run_ast(passes, tree);
 
     /* PROJECT 4: code gen */
+    Report_begin_phase("generate-code");
     InsnList* iloc = generate_code(tree);
 
     /* clean up syntax tree (no longer needed) */
     ASTNode_free(tree);
+    ASTArena_free(arena);
     tree = NULL;
+    Report_end_phase();
 
-    /* PROJECT 5: register allocation */
-    allocate_registers(iloc, 4);
+    /* run ILOC passes (PROJECT 5: register allocation is the "regalloc" pass) */
+    PassManager_run_iloc(passes, iloc);
+    if (print_pass_stats) {
+        PassManager_print_stats(passes, stderr);
+    }
+    PassManager_free(passes);
+    passes = NULL;
 
     /* print ILOC */
     InsnList_print(iloc, stdout);
 
     /* run program (change 'true' to 'false' to disable trace output) */
+    Report_begin_phase("simulate");
     int return_value = run_simulator(iloc, true);
+    Report_end_phase();
     printf("RETURN VALUE = %d\n", return_value);
 
     /* enable this to generate Y86 (requires a functional P5 solution first) */
@@ -178,5 +240,11 @@ int main(int argc, char** argv)
     InsnList_free(iloc);
     iloc = NULL;
 
+    /* print per-phase time and memory report */
+    if (time_report || mem_report) {
+        Report_print(stderr, report_format, time_report, mem_report);
+    }
+    free_interned_strings();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,341 @@
+/**
+ * @file optimize.c
+ * @brief Optional AST and ILOC optimization passes
+ */
+#include <limits.h>
+
+#include "optimize.h"
+
+/*
+ * AST VISITOR: Constant folding
+ */
+
+/**
+ * @brief Checks whether a node is an integer literal
+ */
+bool is_int_literal (ASTNode* node)
+{
+    return node->type == LITERAL && node->literal.type == INT;
+}
+
+/**
+ * @brief Turns an expression node into an integer literal in place
+ *
+ * The node keeps its attributes (e.g., "parent" and "type") so that later
+ * passes see a consistent tree.
+ *
+ * @param node Expression node (its children must already be deallocated)
+ * @param value Literal value
+ */
+void make_int_literal (ASTNode* node, int value)
+{
+    node->type = LITERAL;
+    node->literal.type = INT;
+    node->literal.integer = value;
+}
+
+/**
+ * @brief binary operation post visit for constant folding
+ *
+ * @param visitor
+ * @param node
+ */
+void FoldConstantsVisitor_fold_binaryop (NodeVisitor* visitor, ASTNode* node)
+{
+    ASTNode* left = node->binaryop.left;
+    ASTNode* right = node->binaryop.right;
+    if (!is_int_literal(left) || !is_int_literal(right)) {
+        return;
+    }
+
+    /* compute in a wider type so that overflow can be detected */
+    long a = left->literal.integer;
+    long b = right->literal.integer;
+    long result;
+    switch (node->binaryop.operator) {
+        case ADDOP: result = a + b; break;
+        case SUBOP: result = a - b; break;
+        case MULOP: result = a * b; break;
+        case DIVOP: if (b == 0) { return; } result = a / b; break;
+        case MODOP: if (b == 0) { return; } result = a % b; break;
+        default:
+            return;
+    }
+    if (result < INT_MIN || result > INT_MAX) {
+        return;
+    }
+
+    ASTNode_free(left);
+    ASTNode_free(right);
+    make_int_literal(node, (int)result);
+}
+
+/**
+ * @brief unary operation post visit for constant folding
+ *
+ * @param visitor
+ * @param node
+ */
+void FoldConstantsVisitor_fold_unaryop (NodeVisitor* visitor, ASTNode* node)
+{
+    ASTNode* child = node->unaryop.child;
+    if (node->unaryop.operator != NEGOP || !is_int_literal(child) ||
+        child->literal.integer == INT_MIN) {
+        return;
+    }
+
+    int value = -child->literal.integer;
+    ASTNode_free(child);
+    make_int_literal(node, value);
+}
+
+void fold_constants (ASTNode* tree)
+{
+    NodeVisitor* v = NodeVisitor_new();
+    v->postvisit_binaryop = FoldConstantsVisitor_fold_binaryop;
+    v->postvisit_unaryop  = FoldConstantsVisitor_fold_unaryop;
+    NodeVisitor_traverse_and_free(v, tree);
+}
+
+/**
+ * @brief Count every node (default pre visit for node counting)
+ *
+ * @param visitor
+ * @param node
+ */
+void CountNodesVisitor_previsit (NodeVisitor* visitor, ASTNode* node)
+{
+    (*(int*)visitor->data)++;
+}
+
+int count_ast_nodes (ASTNode* tree)
+{
+    int count = 0;
+    NodeVisitor* v = NodeVisitor_new();
+    v->data = &count;
+    v->previsit_default = CountNodesVisitor_previsit;
+    NodeVisitor_traverse_and_free(v, tree);
+    return count;
+}
+
+
+/*
+ * ILOC peephole passes
+ */
+
+int count_insns (InsnList* list)
+{
+    int count = 0;
+    FOR_EACH(ILOCInsn*, i, list) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Remove and deallocate an instruction from a list
+ *
+ * @param list List to modify
+ * @param prev Instruction before the one to remove (or @c NULL to remove the head)
+ */
+void remove_insn_after (InsnList* list, ILOCInsn* prev)
+{
+    ILOCInsn* victim = (prev == NULL ? list->head : prev->next);
+    if (prev == NULL) {
+        list->head = victim->next;
+    } else {
+        prev->next = victim->next;
+    }
+    if (list->tail == victim) {
+        list->tail = prev;
+    }
+    list->size--;
+    ILOCInsn_free(victim);
+}
+
+/**
+ * @brief Checks whether two operands are the same virtual register
+ */
+bool same_virtual_reg (Operand a, Operand b)
+{
+    return a.type == VIRTUAL_REG && b.type == VIRTUAL_REG && a.id == b.id;
+}
+
+/**
+ * @brief Count how many times each virtual register is read
+ *
+ * @param list ILOC program
+ * @returns Array of @ref MAX_VIRTUAL_REGS read counts (must be deallocated)
+ */
+int* count_reads (InsnList* list)
+{
+    int* reads = (int*)calloc(MAX_VIRTUAL_REGS, sizeof(int));
+    CHECK_MALLOC_PTR(reads);
+    FOR_EACH(ILOCInsn*, i, list) {
+        ILOCInsn* read_regs = ILOCInsn_get_read_registers(i);
+        for (int op = 0; op < 3; op++) {
+            Operand reg = read_regs->op[op];
+            if (reg.type == VIRTUAL_REG && reg.id < MAX_VIRTUAL_REGS) {
+                reads[reg.id]++;
+            }
+        }
+        ILOCInsn_free(read_regs);
+    }
+    return reads;
+}
+
+/**
+ * @brief Checks whether a virtual register is read exactly once
+ */
+bool read_once (int* reads, Operand reg)
+{
+    return reg.type == VIRTUAL_REG && reg.id < MAX_VIRTUAL_REGS && reads[reg.id] == 1;
+}
+
+/**
+ * @brief Checks whether a jump only skips over labels to reach its target
+ */
+bool jumps_to_next (ILOCInsn* jump)
+{
+    for (ILOCInsn* i = jump->next; i != NULL && i->form == LABEL; i = i->next) {
+        if (i->op[0].type == JUMP_LABEL && i->op[0].id == jump->op[0].id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void remove_redundant_jumps (InsnList* list)
+{
+    ILOCInsn* prev = NULL;
+    ILOCInsn* i = list->head;
+    while (i != NULL) {
+        if (i->form == JUMP && jumps_to_next(i)) {
+            remove_insn_after(list, prev);
+            i = (prev == NULL ? list->head : prev->next);
+        } else {
+            prev = i;
+            i = i->next;
+        }
+    }
+}
+
+/**
+ * @brief Find the fused compare-and-branch form for a comparison
+ *
+ * @param cmp Comparison form (e.g., @c CMP_LT)
+ * @param invert Branch if the comparison fails instead
+ * @returns Fused form, or @c NOP if @p cmp is not a comparison
+ */
+InsnForm fused_branch_form (InsnForm cmp, bool invert)
+{
+    switch (cmp) {
+        case CMP_LT: return invert ? CBR_GE : CBR_LT;
+        case CMP_LE: return invert ? CBR_GT : CBR_LE;
+        case CMP_EQ: return invert ? CBR_NE : CBR_EQ;
+        case CMP_GE: return invert ? CBR_LT : CBR_GE;
+        case CMP_GT: return invert ? CBR_LE : CBR_GT;
+        case CMP_NE: return invert ? CBR_EQ : CBR_NE;
+        default:     return NOP;
+    }
+}
+
+void fuse_compare_branches (InsnList* list)
+{
+    int* reads = count_reads(list);
+    for (ILOCInsn* i = list->head; i != NULL; i = i->next) {
+        ILOCInsn* cbr = i->next;
+        if (fused_branch_form(i->form, false) == NOP || cbr == NULL || cbr->form != CBR ||
+            !same_virtual_reg(i->op[2], cbr->op[0]) || !read_once(reads, i->op[2]) ||
+            cbr->next == NULL || cbr->next->form != LABEL ||
+            cbr->next->op[0].type != JUMP_LABEL)
+        {
+            continue;
+        }
+
+        /* branch to whichever target does not immediately follow */
+        int follow = cbr->next->op[0].id;
+        if (follow == cbr->op[1].id) {
+            i->form = fused_branch_form(i->form, true);
+            i->op[2] = cbr->op[2];
+        } else if (follow == cbr->op[2].id) {
+            i->form = fused_branch_form(i->form, false);
+            i->op[2] = cbr->op[1];
+        } else {
+            continue;
+        }
+        remove_insn_after(list, i);
+    }
+    free(reads);
+}
+
+/**
+ * @brief Find the single load/store that uses a scaled offset register
+ *
+ * Only searches within the current straight-line code and gives up if the
+ * index register is overwritten first.
+ *
+ * @param mult Instruction that computes the scaled offset ("multI i, 8 => t")
+ * @returns @c LOAD_AO or @c STORE_AO instruction using @c t as its offset (or
+ * @c NULL if there is none)
+ */
+ILOCInsn* find_scaled_offset_use (ILOCInsn* mult)
+{
+    Operand index = mult->op[0];
+    Operand offset = mult->op[2];
+    for (ILOCInsn* i = mult->next; i != NULL; i = i->next) {
+        switch (i->form) {
+            case LOAD_AO:
+                if (same_virtual_reg(i->op[1], offset) && !same_virtual_reg(i->op[0], offset)) {
+                    return i;
+                }
+                break;
+            case STORE_AO:
+                if (same_virtual_reg(i->op[2], offset) && !same_virtual_reg(i->op[0], offset) &&
+                    !same_virtual_reg(i->op[1], offset)) {
+                    return i;
+                }
+                break;
+            case LABEL: case JUMP: case CBR: case CALL: case RETURN:
+            case CBR_LT: case CBR_LE: case CBR_EQ: case CBR_NE: case CBR_GE: case CBR_GT:
+                return NULL;
+            default:
+                break;
+        }
+        if (same_virtual_reg(ILOCInsn_get_write_register(i), index)) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+void fold_scaled_index (InsnList* list)
+{
+    int* reads = count_reads(list);
+    ILOCInsn* prev = NULL;
+    ILOCInsn* i = list->head;
+    while (i != NULL) {
+        ILOCInsn* use = NULL;
+        if (i->form == MULT_I && i->op[1].imm == WORD_SIZE &&
+            i->op[0].type == VIRTUAL_REG && read_once(reads, i->op[2])) {
+            use = find_scaled_offset_use(i);
+        }
+        if (use == NULL) {
+            prev = i;
+            i = i->next;
+            continue;
+        }
+
+        /* address the unscaled index directly and drop the multiply */
+        if (use->form == LOAD_AO) {
+            use->form = LOAD_AS;
+            use->op[1] = i->op[0];
+        } else {
+            use->form = STORE_AS;
+            use->op[2] = i->op[0];
+        }
+        remove_insn_after(list, prev);
+        i = (prev == NULL ? list->head : prev->next);
+    }
+    free(reads);
+}
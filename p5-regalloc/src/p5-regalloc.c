@@ -173,18 +173,28 @@ void allocate_registers(InsnList* list, int num_reg) {
         // for each read vr in i:
         // pr = ensure(vr)                     // make sure vr is in a phys reg
         // replace vr with pr in i             // change register id
-        // if dist(vr) == INFINITY:            // if no future use
-        // name[pr] = INVALID                  // then free pr
+        //
+        // every read must be in place before any of them is freed; otherwise
+        // a later reload (e.g. a spilled index in storeAS) can land in the
+        // register of an operand this same instruction still has to read
         ILOCInsn* read_regs = ILOCInsn_get_read_registers(i);
+        int read_pr[3];
         for (int op = 0; op < 3; op++) {
             Operand vr = read_regs->op[op];
+            read_pr[op] = INVALID;
             if (vr.type == VIRTUAL_REG) {
-                int pr = ensure(vr.id, reference_to_i, local_allocator, num_reg);
-                replace_register(vr.id, pr, i);
+                read_pr[op] = ensure(vr.id, reference_to_i, local_allocator, num_reg);
+                replace_register(vr.id, read_pr[op], i);
+            }
+        }
 
-                if (dist(vr.id, i->next) == INFINITY) {
-                    name[pr] = INVALID;
-                }
+        // for each read vr in i:
+        // if dist(vr) == INFINITY:            // if no future use
+        // name[pr] = INVALID                  // then free pr
+        for (int op = 0; op < 3; op++) {
+            Operand vr = read_regs->op[op];
+            if (vr.type == VIRTUAL_REG && dist(vr.id, i->next) == INFINITY) {
+                name[read_pr[op]] = INVALID;
             }
         }
         ILOCInsn_free(read_regs);
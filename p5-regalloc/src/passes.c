@@ -0,0 +1,162 @@
+/**
+ * @file passes.c
+ * @brief Pass manager for configurable AST and ILOC pipelines
+ */
+#include "passes.h"
+#include "optimize.h"
+#include "p5-regalloc.h"
+#include "report.h"
+
+/**
+ * @brief Register allocation pass (wraps @ref allocate_registers)
+ *
+ * @param list ILOC program
+ */
+void run_regalloc (InsnList* list)
+{
+    allocate_registers(list, NUM_PHYSICAL_REGS);
+}
+
+/**
+ * @brief All passes that can be named in a pipeline
+ */
+const Pass pass_registry[] = {
+    { "fold-constants", AST_PASS,  fold_constants, NULL                   },
+    { "remove-jumps",   ILOC_PASS, NULL,           remove_redundant_jumps },
+    { "fuse-branches",  ILOC_PASS, NULL,           fuse_compare_branches  },
+    { "scaled-index",   ILOC_PASS, NULL,           fold_scaled_index      },
+    { "regalloc",       ILOC_PASS, NULL,           run_regalloc           },
+};
+
+/**
+ * @brief Pipelines for each optimization level preset
+ */
+const char* pass_presets[] = {
+    /* -O0 */ "regalloc",
+    /* -O1 */ "fold-constants,remove-jumps,regalloc",
+    /* -O2 */ "fold-constants,fuse-branches,scaled-index,remove-jumps,regalloc",
+};
+
+/**
+ * @brief Look up a registered pass by name
+ *
+ * @param name Pass name
+ * @returns Pointer to pass (or @c NULL if there is no such pass)
+ */
+const Pass* find_pass (const char* name)
+{
+    int num_registered = sizeof(pass_registry) / sizeof(Pass);
+    for (int i = 0; i < num_registered; i++) {
+        if (strcmp(pass_registry[i].name, name) == 0) {
+            return &pass_registry[i];
+        }
+    }
+    return NULL;
+}
+
+PassManager* PassManager_new (void)
+{
+    PassManager* pm = (PassManager*)calloc(1, sizeof(PassManager));
+    CHECK_MALLOC_PTR(pm);
+    pm->num_passes = 0;
+    return pm;
+}
+
+bool PassManager_add (PassManager* pm, const char* name)
+{
+    const Pass* pass = find_pass(name);
+    if (pass == NULL || pm->num_passes >= MAX_PASSES) {
+        return false;
+    }
+    if (pass->kind == AST_PASS && pm->num_passes > 0 &&
+        pm->passes[pm->num_passes-1].pass->kind == ILOC_PASS) {
+        return false;
+    }
+    PassStats* stats = &pm->passes[pm->num_passes++];
+    stats->pass = pass;
+    stats->ran = false;
+    return true;
+}
+
+bool PassManager_add_list (PassManager* pm, const char* names)
+{
+    char buffer[MAX_LINE_LEN];
+    snprintf(buffer, MAX_LINE_LEN, "%s", names);
+    for (char* name = strtok(buffer, ","); name != NULL; name = strtok(NULL, ",")) {
+        if (!PassManager_add(pm, name)) {
+            if (find_pass(name) == NULL) {
+                fprintf(stderr, "Unknown pass: %s\n", name);
+            } else {
+                fprintf(stderr, "Cannot add pass: %s (too many passes or AST pass after ILOC pass)\n", name);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PassManager_add_preset (PassManager* pm, int level)
+{
+    int num_presets = sizeof(pass_presets) / sizeof(const char*);
+    if (level < 0 || level >= num_presets) {
+        return false;
+    }
+    return PassManager_add_list(pm, pass_presets[level]);
+}
+
+void PassManager_run_ast (PassManager* pm, ASTNode* tree)
+{
+    for (int i = 0; i < pm->num_passes; i++) {
+        PassStats* stats = &pm->passes[i];
+        if (stats->pass->kind != AST_PASS) {
+            continue;
+        }
+        stats->size_before = count_ast_nodes(tree);
+        Report_begin_phase(stats->pass->name);
+        double start = wall_time();
+        stats->pass->run_ast(tree);
+        stats->seconds = wall_time() - start;
+        Report_end_phase();
+        stats->size_after = count_ast_nodes(tree);
+        stats->ran = true;
+    }
+}
+
+void PassManager_run_iloc (PassManager* pm, InsnList* list)
+{
+    for (int i = 0; i < pm->num_passes; i++) {
+        PassStats* stats = &pm->passes[i];
+        if (stats->pass->kind != ILOC_PASS) {
+            continue;
+        }
+        stats->size_before = count_insns(list);
+        Report_begin_phase(stats->pass->name);
+        double start = wall_time();
+        stats->pass->run_iloc(list);
+        stats->seconds = wall_time() - start;
+        Report_end_phase();
+        stats->size_after = count_insns(list);
+        stats->ran = true;
+    }
+}
+
+void PassManager_print_stats (PassManager* pm, FILE* output)
+{
+    fprintf(output, "%-16s %-6s %12s %8s %8s %8s\n",
+            "PASS", "KIND", "TIME (ms)", "BEFORE", "AFTER", "DELTA");
+    for (int i = 0; i < pm->num_passes; i++) {
+        PassStats* stats = &pm->passes[i];
+        if (!stats->ran) {
+            continue;
+        }
+        fprintf(output, "%-16s %-6s %12.3f %8d %8d %+8d\n",
+                stats->pass->name, (stats->pass->kind == AST_PASS ? "ast" : "iloc"),
+                stats->seconds * 1000.0, stats->size_before, stats->size_after,
+                stats->size_after - stats->size_before);
+    }
+}
+
+void PassManager_free (PassManager* pm)
+{
+    free(pm);
+}
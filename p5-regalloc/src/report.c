@@ -0,0 +1,271 @@
+/**
+ * @file report.c
+ * @brief Per-phase compile time and memory reports (-ftime-report/-fmem-report)
+ */
+#include <time.h>
+
+#include "report.h"
+
+/**
+ * @brief Statistics recorded for a single phase
+ */
+typedef struct PhaseStats
+{
+    const char* name;           /**< @brief Phase name */
+    double wall_seconds;        /**< @brief Elapsed wall clock time */
+    double cpu_seconds;         /**< @brief Elapsed processor time */
+    size_t allocated_bytes;     /**< @brief Bytes allocated during the phase */
+    size_t allocations;         /**< @brief Number of allocations during the phase */
+    long peak_bytes;            /**< @brief Maximum live heap bytes during the phase */
+} PhaseStats;
+
+/**
+ * @brief All recorded phases (in order)
+ */
+PhaseStats report_phases[MAX_PHASES];
+
+/**
+ * @brief Number of recorded phases
+ */
+int report_num_phases = 0;
+
+/**
+ * @brief True if phases are being recorded
+ */
+bool report_enabled = false;
+
+/**
+ * @brief Phase currently being recorded (or @c NULL if there is none)
+ */
+PhaseStats* report_current = NULL;
+
+/**
+ * @brief Wall and CPU time at the start of the current phase
+ */
+double report_wall_start, report_cpu_start;
+
+/**
+ * @brief Allocation counters at the start of the current phase
+ */
+size_t report_bytes_start, report_allocs_start;
+
+/*
+ * Allocation tracking (see the Makefile for the linker flags)
+ */
+
+/**
+ * @brief Total bytes allocated so far
+ */
+size_t total_allocated_bytes = 0;
+
+/**
+ * @brief Total number of allocations so far
+ */
+size_t total_allocations = 0;
+
+/**
+ * @brief Bytes currently allocated
+ *
+ * This is signed because memory allocated inside the C library (e.g., by
+ * @c strdup) is not counted but may be freed by tracked code.
+ */
+long live_bytes = 0;
+
+#ifdef TRACK_ALLOCATIONS
+
+#include <malloc.h>
+
+void* __real_malloc (size_t size);
+void* __real_calloc (size_t nmemb, size_t size);
+void* __real_realloc (void* ptr, size_t size);
+void  __real_free (void* ptr);
+
+/**
+ * @brief Add a new block to the allocation counters
+ */
+void record_alloc (void* ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+    size_t size = malloc_usable_size(ptr);
+    total_allocated_bytes += size;
+    total_allocations++;
+    live_bytes += (long)size;
+    if (report_current != NULL && live_bytes > report_current->peak_bytes) {
+        report_current->peak_bytes = live_bytes;
+    }
+}
+
+void* __wrap_malloc (size_t size)
+{
+    void* ptr = __real_malloc(size);
+    record_alloc(ptr);
+    return ptr;
+}
+
+void* __wrap_calloc (size_t nmemb, size_t size)
+{
+    void* ptr = __real_calloc(nmemb, size);
+    record_alloc(ptr);
+    return ptr;
+}
+
+void* __wrap_realloc (void* ptr, size_t size)
+{
+    size_t old_size = (ptr == NULL ? 0 : malloc_usable_size(ptr));
+    void* new_ptr = __real_realloc(ptr, size);
+    if (new_ptr != NULL || size == 0) {
+        live_bytes -= (long)old_size;
+    }
+    record_alloc(new_ptr);
+    return new_ptr;
+}
+
+void __wrap_free (void* ptr)
+{
+    if (ptr != NULL) {
+        live_bytes -= (long)malloc_usable_size(ptr);
+    }
+    __real_free(ptr);
+}
+
+#endif
+
+double wall_time (void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Get the processor time used so far in seconds
+ */
+double cpu_time (void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+void Report_enable (void)
+{
+    report_enabled = true;
+}
+
+void Report_begin_phase (const char* name)
+{
+    if (!report_enabled || report_num_phases >= MAX_PHASES) {
+        return;
+    }
+    Report_end_phase();
+
+    report_current = &report_phases[report_num_phases++];
+    report_current->name = name;
+    report_current->peak_bytes = live_bytes;
+    report_bytes_start = total_allocated_bytes;
+    report_allocs_start = total_allocations;
+    report_cpu_start = cpu_time();
+    report_wall_start = wall_time();
+}
+
+void Report_end_phase (void)
+{
+    if (report_current == NULL) {
+        return;
+    }
+    report_current->wall_seconds = wall_time() - report_wall_start;
+    report_current->cpu_seconds = cpu_time() - report_cpu_start;
+    report_current->allocated_bytes = total_allocated_bytes - report_bytes_start;
+    report_current->allocations = total_allocations - report_allocs_start;
+    report_current = NULL;
+}
+
+/**
+ * @brief Add the statistics for a phase to a running total
+ */
+void add_phase_stats (PhaseStats* total, PhaseStats* phase)
+{
+    total->wall_seconds += phase->wall_seconds;
+    total->cpu_seconds += phase->cpu_seconds;
+    total->allocated_bytes += phase->allocated_bytes;
+    total->allocations += phase->allocations;
+    if (phase->peak_bytes > total->peak_bytes) {
+        total->peak_bytes = phase->peak_bytes;
+    }
+}
+
+/**
+ * @brief Print a single row of the human-readable report
+ */
+void print_phase_text (FILE* output, PhaseStats* phase, bool show_time, bool show_mem)
+{
+    fprintf(output, "%-20s", phase->name);
+    if (show_time) {
+        fprintf(output, " %12.3f %12.3f", phase->wall_seconds * 1000.0, phase->cpu_seconds * 1000.0);
+    }
+    if (show_mem) {
+        fprintf(output, " %14zu %8zu %14ld", phase->allocated_bytes, phase->allocations,
+                phase->peak_bytes);
+    }
+    fprintf(output, "\n");
+}
+
+/**
+ * @brief Print a single phase as a JSON object
+ */
+void print_phase_json (FILE* output, PhaseStats* phase, bool show_time, bool show_mem)
+{
+    fprintf(output, "{\"name\": \"%s\"", phase->name);
+    if (show_time) {
+        fprintf(output, ", \"wall_ms\": %.3f, \"cpu_ms\": %.3f",
+                phase->wall_seconds * 1000.0, phase->cpu_seconds * 1000.0);
+    }
+    if (show_mem) {
+        fprintf(output, ", \"allocated_bytes\": %zu, \"allocations\": %zu, \"peak_bytes\": %ld",
+                phase->allocated_bytes, phase->allocations, phase->peak_bytes);
+    }
+    fprintf(output, "}");
+}
+
+void Report_print (FILE* output, ReportFormat format, bool show_time, bool show_mem)
+{
+    Report_end_phase();
+
+#ifndef TRACK_ALLOCATIONS
+    if (show_mem && format == REPORT_TEXT) {
+        fprintf(output, "(memory statistics are unavailable in this build)\n");
+    }
+    show_mem = false;
+#endif
+
+    PhaseStats total = { .name = "TOTAL" };
+    for (int i = 0; i < report_num_phases; i++) {
+        add_phase_stats(&total, &report_phases[i]);
+    }
+
+    if (format == REPORT_JSON) {
+        fprintf(output, "{\"memory_tracking\": %s, \"phases\": [",
+                (show_mem ? "true" : "false"));
+        for (int i = 0; i < report_num_phases; i++) {
+            fprintf(output, "%s\n  ", (i == 0 ? "" : ","));
+            print_phase_json(output, &report_phases[i], show_time, show_mem);
+        }
+        fprintf(output, "],\n  \"total\": ");
+        print_phase_json(output, &total, show_time, show_mem);
+        fprintf(output, "}\n");
+        return;
+    }
+
+    fprintf(output, "%-20s", "PHASE");
+    if (show_time) {
+        fprintf(output, " %12s %12s", "WALL (ms)", "CPU (ms)");
+    }
+    if (show_mem) {
+        fprintf(output, " %14s %8s %14s", "ALLOC (bytes)", "ALLOCS", "PEAK (bytes)");
+    }
+    fprintf(output, "\n");
+    for (int i = 0; i < report_num_phases; i++) {
+        print_phase_text(output, &report_phases[i], show_time, show_mem);
+    }
+    print_phase_text(output, &total, show_time, show_mem);
+}
@@ -1,22 +1,90 @@
 #include "token.h"
 
+/**
+ * @brief Compiled regular expression and what is known about its matches
+ *
+ * @ref Regex_new returns a pointer to the @c regex member, so callers only
+ * ever see a @c regex_t.
+ */
+typedef struct RegexInfo
+{
+    regex_t regex;      /**< @brief Compiled expression (must be first) */
+    bool single_line;   /**< @brief True if no match can contain a newline */
+} RegexInfo;
+
+/**
+ * @brief Check whether a POSIX extended regular expression can never match a
+ * newline (conservatively: false if in doubt)
+ */
+bool regex_is_single_line (const char* regex)
+{
+    for (const char* p = regex; *p != '\0'; p++) {
+        if (*p == '\n' || *p == '.') {
+            return false;
+        } else if (*p == '\\' && p[1] != '\0') {
+            p++;
+        } else if (*p == '[') {
+            /* bracket expression: a newline matches unless it is excluded */
+            bool negated = (p[1] == '^');
+            const char* q = p + (negated ? 2 : 1);
+            bool has_newline = false;
+            if (*q == ']') {
+                q++;
+            }
+            for (; *q != '\0' && *q != ']'; q++) {
+                if (*q == '[' && (q[1] == ':' || q[1] == '.' || q[1] == '=')) {
+                    return false;
+                }
+                if (q[1] == '-' && q[2] != ']' && q[2] != '\0') {
+                    has_newline = has_newline || (q[0] <= '\n' && '\n' <= q[2]);
+                    q += 2;
+                } else {
+                    has_newline = has_newline || *q == '\n';
+                }
+            }
+            if (*q == '\0' || negated != has_newline) {
+                return false;
+            }
+            p = q;
+        }
+    }
+    return true;
+}
+
 Regex* Regex_new (const char* regex)
 {
-    Regex* r = (Regex*)calloc(1, sizeof(Regex));
-    CHECK_MALLOC_PTR(r)
+    RegexInfo* info = (RegexInfo*)calloc(1, sizeof(RegexInfo));
+    CHECK_MALLOC_PTR(info)
     /* regcomp initializes a regex_t, for which Regex is just a typedef */
-    regcomp(r, regex, REG_EXTENDED);
-    return r;
+    regcomp(&info->regex, regex, REG_EXTENDED);
+    info->single_line = regex_is_single_line(regex);
+    return &info->regex;
 }
 
 bool Regex_match (Regex *regex, const char *text, char *match)
 {
     /* only save one element becase, we only care about the whole-regex match */
     regmatch_t matches[1];
-    if (regexec(regex, text, 1, matches, 0) == 0) {
+    int flags = 0;
+#ifdef REG_STARTEND
+    /* if a match cannot contain a newline, search only the rest of the
+     * current line; otherwise expressions that the regex library does not
+     * anchor (e.g., "^0|^[1-9][0-9]*") scan the rest of the input on every
+     * call, which makes lexing quadratic */
+    const char* newline = (((RegexInfo*)regex)->single_line ? strchr(text, '\n') : NULL);
+    if (newline != NULL) {
+        matches[0].rm_so = 0;
+        matches[0].rm_eo = newline - text;
+        flags = REG_STARTEND | REG_NOTEOL;
+    }
+#endif
+    if (regexec(regex, text, 1, matches, flags) == 0) {
 
-        /* save the match into the given string buffer */
-        snprintf(match, matches[0].rm_eo+1, "%s", text);
+        /* save the match into the given string buffer (copy only the match;
+         * formatting the rest of the text would also be quadratic) */
+        size_t len = (size_t)matches[0].rm_eo;
+        memcpy(match, text, len);
+        match[len] = '\0';
         return true;
     }
     return false;
@@ -25,7 +93,7 @@ bool Regex_match (Regex *regex, const char *text, char *match)
 void Regex_free (Regex* regex)
 {
     regfree(regex); /* clean up regex_t structure */
-    free(regex);
+    free((RegexInfo*)regex);
 }
 
 const char* TokenType_to_string (TokenType type)
@@ -41,25 +109,196 @@ const char* TokenType_to_string (TokenType type)
     return "INVALID";
 }
 
+/**
+ * @brief Return a keyword if the word exactly matches its text
+ */
+#define WORD_IS(WORD,KW) (memcmp(text, WORD, len) == 0 ? KW : NOT_KEYWORD)
+
+Keyword Keyword_classify (const char* text, size_t len)
+{
+    switch (len) {
+        case 2:
+            return WORD_IS("if", KW_IF);
+        case 3:
+            switch (text[0]) {
+                case 'd': return WORD_IS("def", KW_DEF);
+                case 'i': return WORD_IS("int", KW_INT);
+                case 'f': return WORD_IS("for", RESERVED_WORD);
+                case 'n': return WORD_IS("new", RESERVED_WORD);
+            }
+            break;
+        case 4:
+            switch (text[0]) {
+                case 'e': return WORD_IS("else", KW_ELSE);
+                case 'b': return WORD_IS("bool", KW_BOOL);
+                case 'v': return WORD_IS("void", KW_VOID);
+                case 't': return text[1] == 'r' ? WORD_IS("true", KW_TRUE)
+                                                : WORD_IS("this", RESERVED_WORD);
+                case 'n': return WORD_IS("null", RESERVED_WORD);
+            }
+            break;
+        case 5:
+            switch (text[0]) {
+                case 'w': return WORD_IS("while", KW_WHILE);
+                case 'b': return WORD_IS("break", KW_BREAK);
+                case 'f': return text[1] == 'a' ? WORD_IS("false", KW_FALSE)
+                                                : WORD_IS("float", RESERVED_WORD);
+                case 'c': return WORD_IS("class", RESERVED_WORD);
+            }
+            break;
+        case 6:
+            switch (text[0]) {
+                case 'r': return WORD_IS("return", KW_RETURN);
+                case 's': return WORD_IS("string", RESERVED_WORD);
+                case 'd': return WORD_IS("double", RESERVED_WORD);
+            }
+            break;
+        case 7:
+            switch (text[0]) {
+                case 'c': return WORD_IS("callout", RESERVED_WORD);
+                case 'e': return WORD_IS("extends", RESERVED_WORD);
+            }
+            break;
+        case 8:
+            return WORD_IS("continue", KW_CONTINUE);
+        case 9:
+            return WORD_IS("interface", RESERVED_WORD);
+        case 10:
+            return WORD_IS("implements", RESERVED_WORD);
+    }
+    return NOT_KEYWORD;
+}
+
+TokenKind TokenKind_classify (TokenType type, const char* text, size_t len)
+{
+    if (type == KEY) {
+        switch (Keyword_classify(text, len)) {
+            case KW_DEF:      return TK_DEF;
+            case KW_IF:       return TK_IF;
+            case KW_ELSE:     return TK_ELSE;
+            case KW_WHILE:    return TK_WHILE;
+            case KW_RETURN:   return TK_RETURN;
+            case KW_BREAK:    return TK_BREAK;
+            case KW_CONTINUE: return TK_CONTINUE;
+            case KW_INT:      return TK_INT;
+            case KW_BOOL:     return TK_BOOL;
+            case KW_VOID:     return TK_VOID;
+            case KW_TRUE:     return TK_TRUE;
+            case KW_FALSE:    return TK_FALSE;
+            default:          return TK_NONE;
+        }
+    }
+    if (type != SYM || len == 0 || len > 2) {
+        return TK_NONE;
+    }
+    if (len == 2) {
+        char second = text[1];
+        switch (text[0]) {
+            case '|': return second == '|' ? TK_OR : TK_NONE;
+            case '&': return second == '&' ? TK_AND : TK_NONE;
+            case '=': return second == '=' ? TK_EQ : TK_NONE;
+            case '!': return second == '=' ? TK_NE : TK_NONE;
+            case '<': return second == '=' ? TK_LE : TK_NONE;
+            case '>': return second == '=' ? TK_GE : TK_NONE;
+        }
+        return TK_NONE;
+    }
+    switch (text[0]) {
+        case '<':  return TK_LT;
+        case '>':  return TK_GT;
+        case '+':  return TK_PLUS;
+        case '-':  return TK_MINUS;
+        case '*':  return TK_STAR;
+        case '/':  return TK_SLASH;
+        case '%':  return TK_PERCENT;
+        case '!':  return TK_NOT;
+        case '=':  return TK_ASSIGN;
+        case '(':  return TK_LPAREN;
+        case ')':  return TK_RPAREN;
+        case '[':  return TK_LBRACKET;
+        case ']':  return TK_RBRACKET;
+        case '{':  return TK_LBRACE;
+        case '}':  return TK_RBRACE;
+        case ';':  return TK_SEMI;
+        case ',':  return TK_COMMA;
+        case '\\': return TK_BACKSLASH;
+    }
+    return TK_NONE;
+}
+
+const char* TokenKind_to_string (TokenKind kind)
+{
+    static const char* const text[NUM_TOKEN_KINDS] = {
+        [TK_NONE] = "",
+        [TK_OR] = "||", [TK_AND] = "&&", [TK_EQ] = "==", [TK_NE] = "!=",
+        [TK_LT] = "<", [TK_LE] = "<=", [TK_GE] = ">=", [TK_GT] = ">",
+        [TK_PLUS] = "+", [TK_MINUS] = "-", [TK_STAR] = "*", [TK_SLASH] = "/",
+        [TK_PERCENT] = "%", [TK_NOT] = "!",
+        [TK_ASSIGN] = "=", [TK_LPAREN] = "(", [TK_RPAREN] = ")",
+        [TK_LBRACKET] = "[", [TK_RBRACKET] = "]", [TK_LBRACE] = "{",
+        [TK_RBRACE] = "}", [TK_SEMI] = ";", [TK_COMMA] = ",", [TK_BACKSLASH] = "\\",
+        [TK_DEF] = "def", [TK_IF] = "if", [TK_ELSE] = "else", [TK_WHILE] = "while",
+        [TK_RETURN] = "return", [TK_BREAK] = "break", [TK_CONTINUE] = "continue",
+        [TK_INT] = "int", [TK_BOOL] = "bool", [TK_VOID] = "void",
+        [TK_TRUE] = "true", [TK_FALSE] = "false",
+    };
+    return (kind >= 0 && kind < NUM_TOKEN_KINDS) ? text[kind] : "";
+}
+
 bool token_str_eq (const char* str1, const char* str2)
 {
     return strncmp(str1, str2, MAX_TOKEN_LEN) == 0;
 }
 
+char* TokenSpan_text (const char* source, const TokenSpan* span, char* buffer)
+{
+    size_t len = (span->length < MAX_TOKEN_LEN ? span->length : MAX_TOKEN_LEN - 1);
+    memcpy(buffer, source + span->offset, len);
+    buffer[len] = '\0';
+    return buffer;
+}
+
+bool TokenSpan_text_eq (const char* source, const TokenSpan* span, const char* str)
+{
+    return strncmp(source + span->offset, str, span->length) == 0 && str[span->length] == '\0';
+}
+
+/**
+ * @brief Block that @ref Token_new is carving tokens out of (or @c NULL)
+ */
+TokenBlock* token_block = NULL;
+
 Token* Token_new (TokenType type, const char* text, int line)
 {
-    Token* token = (Token*)calloc(1, sizeof(Token));
-    CHECK_MALLOC_PTR(token)
+    /* start a new block if the current one is full (the old one is freed
+     * along with its last token) */
+    if (token_block == NULL || token_block->used == TOKEN_BLOCK_SIZE) {
+        token_block = (TokenBlock*)calloc(1, sizeof(TokenBlock));
+        CHECK_MALLOC_PTR(token_block)
+    }
+    Token* token = &token_block->tokens[token_block->used++];
+    token_block->live++;
+    token->block = token_block;
     token->type = type;
     snprintf(token->text, MAX_TOKEN_LEN, "%s", text);
     token->line = line;
     token->next = NULL;
+    token->kind = TokenKind_classify(type, token->text, strlen(token->text));
     return token;
 }
 
 void Token_free (Token* token)
 {
-    free(token);
+    if (token == NULL || token->in_arena) {
+        return;
+    }
+    TokenBlock* block = token->block;
+    if (--block->live == 0) {
+        if (block == token_block) {
+            token_block = NULL;
+        }
+        free(block);
+    }
 }
 
 TokenQueue* TokenQueue_new (void)
@@ -71,6 +310,14 @@ TokenQueue* TokenQueue_new (void)
 
 void TokenQueue_add (TokenQueue* queue, Token* token)
 {
+    /* index the token (growing the index if necessary) */
+    if (queue->count == queue->capacity) {
+        queue->capacity = (queue->capacity == 0 ? 64 : queue->capacity * 2);
+        queue->items = (Token**)realloc(queue->items, queue->capacity * sizeof(Token*));
+        CHECK_MALLOC_PTR(queue->items)
+    }
+    queue->items[queue->count++] = token;
+
     if (queue->head == NULL) {
         /* empty list: new token is both head and tail */
         queue->head = token;
@@ -82,6 +329,25 @@ void TokenQueue_add (TokenQueue* queue, Token* token)
     }
 }
 
+void TokenQueue_add_span (TokenQueue* queue, const char* source, const TokenSpan* span)
+{
+    /* start a new arena block if the current one is full */
+    if (queue->blocks == NULL || queue->blocks->used == TOKEN_BLOCK_SIZE) {
+        TokenBlock* block = (TokenBlock*)calloc(1, sizeof(TokenBlock));
+        CHECK_MALLOC_PTR(block)
+        block->next = queue->blocks;
+        queue->blocks = block;
+    }
+    Token* token = &queue->blocks->tokens[queue->blocks->used++];
+    token->type = span->type;
+    TokenSpan_text(source, span, token->text);
+    token->line = span->line;
+    token->next = NULL;
+    token->in_arena = true;
+    token->kind = span->kind;
+    TokenQueue_add(queue, token);
+}
+
 Token* TokenQueue_peek (TokenQueue* queue)
 {
     return queue->head;
@@ -96,6 +362,7 @@ Token* TokenQueue_remove (TokenQueue* queue)
         /* queue is non-empty: remove a token from head and return it */
         Token* tmp = queue->head;
         queue->head = queue->head->next;
+        queue->cursor++;
         if (queue->head == NULL) {
             queue->tail = NULL;    /* just removed the last item */
         }
@@ -108,21 +375,30 @@ bool TokenQueue_is_empty (TokenQueue* queue)
     return queue->head == NULL;
 }
 
-size_t TokenQueue_size (TokenQueue* queue)
+Token* TokenQueue_peek_ahead (TokenQueue* queue, size_t k)
 {
-    size_t size = 0;
-    for (Token* cur = queue->head; cur != NULL; cur = cur->next) {
-        size++;
+    if (k >= TokenQueue_size(queue)) {
+        return NULL;
     }
-    return size;
+    return queue->items[queue->cursor + k];
+}
+
+size_t TokenQueue_size (TokenQueue* queue)
+{
+    return queue->count - queue->cursor;
+}
+
+void Token_print (Token* token, FILE* out)
+{
+    fprintf(out, "%-8s [line %03d]  %s\n",
+            TokenType_to_string(token->type),
+            token->line, token->text);
 }
 
 void TokenQueue_print (TokenQueue* queue, FILE* out)
 {
     for (Token* t = queue->head; t != NULL; t = t->next) {
-        fprintf(out, "%-8s [line %03d]  %s\n",
-                TokenType_to_string(t->type),
-                t->line, t->text);
+        Token_print(t, out);
     }
 }
 
@@ -132,5 +408,13 @@ void TokenQueue_free (TokenQueue* queue)
     while (!TokenQueue_is_empty(queue)) {
         Token_free(TokenQueue_remove(queue));
     }
+
+    /* clean up arena and index */
+    while (queue->blocks != NULL) {
+        TokenBlock* next = queue->blocks->next;
+        free(queue->blocks);
+        queue->blocks = next;
+    }
+    free(queue->items);
     free(queue);
 }
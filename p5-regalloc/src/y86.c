@@ -117,6 +117,23 @@ void emit_cmp (const char* opcode, Operand op0, Operand op1, Operand op2)
     emitf("rrmovq %s, %s", TMP1, reg_name(op2));
 }
 
+void emit_scaled_addr (Operand base, Operand index)
+{
+    /* index * WORD_SIZE by repeated doubling (Y86 has no shifts) */
+    emitf("rrmovq %s, %s", reg_name(index), TMP1);
+    for (int scale = 1; scale < WORD_SIZE; scale *= 2) {
+        emitf("addq %s, %s", TMP1, TMP1);
+    }
+    emitf("addq %s, %s", reg_name(base), TMP1);
+}
+
+void emit_cbr (const char* opcode, Operand op0, Operand op1, Operand op2)
+{
+    emitf("rrmovq %s, %s", reg_name(op0), TMP1);
+    emitf("subq %s, %s", reg_name(op1), TMP1);
+    emitf("j%s l%d", opcode, op2.id);   /* true (otherwise fall through) */
+}
+
 #define OP0 (i->op[0])
 #define OP1 (i->op[1])
 #define OP2 (i->op[2])
@@ -132,6 +149,7 @@ void emit_y86 (InsnList* iloc, FILE* output)
     int num_strings = 0;
     bool need_mult = false;
     bool need_div = false;
+    bool need_bounds = false;
 
     out = output;
 
@@ -174,6 +192,10 @@ void emit_y86 (InsnList* iloc, FILE* output)
             case STORE_AO:  emitf("rrmovq %s, %s", REG1, TMP1);
                             emitf("addq %s, %s", REG2, TMP1);
                             emitf("rmmovq %s, (%s)", REG0, TMP1);               break;
+            case LOAD_AS:   emit_scaled_addr(OP0, OP1);
+                            emitf("mrmovq (%s), %s", TMP1, REG2);               break;
+            case STORE_AS:  emit_scaled_addr(OP1, OP2);
+                            emitf("rmmovq %s, (%s)", REG0, TMP1);               break;
 
             /* unary and binary operations (complicated by Y86's minimal OPq instruction) */
 
@@ -261,6 +283,15 @@ void emit_y86 (InsnList* iloc, FILE* output)
                 emitf("jmp l%d", OP2.id); /* false */
                 break;
 
+            /* fused compare-and-branch -- delegate to helper method that uses jXX */
+
+            case CBR_GT: emit_cbr("g",  OP0, OP1, OP2); break;
+            case CBR_GE: emit_cbr("ge", OP0, OP1, OP2); break;
+            case CBR_LT: emit_cbr("l",  OP0, OP1, OP2); break;
+            case CBR_LE: emit_cbr("le", OP0, OP1, OP2); break;
+            case CBR_EQ: emit_cbr("e",  OP0, OP1, OP2); break;
+            case CBR_NE: emit_cbr("ne", OP0, OP1, OP2); break;
+
             case CALL:
                 emitf("call %s", OP0.str);
                 break;
@@ -314,6 +345,16 @@ void emit_y86 (InsnList* iloc, FILE* output)
                 emit("nop");    /* not really necessary; included for completeness */
                 break;
 
+            /* 0 <= r1 < c1, otherwise halt */
+            case BOUNDS:    emitf("rrmovq %s, %s", REG0, TMP1);
+                            emitf("andq %s, %s", TMP1, TMP1);
+                            emit("jl _bounds_error");
+                            emitf("irmovq $%d, %s", OP1.imm, TMP2);
+                            emitf("subq %s, %s", TMP2, TMP1);
+                            emit("jge _bounds_error");
+                            need_bounds = true;
+                            break;
+
             case PHI:
                 /* nothing to do */
                 break;
@@ -357,6 +398,12 @@ void emit_y86 (InsnList* iloc, FILE* output)
         emit("ret");                        /* return div in TMP3 */
     }
 
+    if (need_bounds) {
+        emit("");
+        emit_call_label("_bounds_error");
+        emit("halt");
+    }
+
     /* emit string table if needed */
     if (num_strings > 0) {
         emit("");
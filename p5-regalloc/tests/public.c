@@ -106,6 +106,47 @@ TEST_PROGRAM(B_recursion2, 1597,
         "def int main() { return fib(17); }")
 
 
+// Optimization pipelines (results must match the unoptimized program)
+#define OPT_PROGRAM \
+        "int a[4]; " \
+        "def int main() { " \
+        "  int i; int s; i = 0; s = 2 * 3 - -1; " \
+        "  while (i < 4) { a[i] = i * (10 / 5); i = i + 1; } " \
+        "  i = 0; " \
+        "  while (i != 4) { if (a[i] >= 4) { s = s + a[i]; } i = i + 1; } " \
+        "  return s; }"
+// Per-phase reports from the driver (see -ftime-report/-fmem-report)
+START_TEST (B_phase_report_text)
+{ ck_assert (valid_phase_report("-ftime-report -fmem-report inputs/sanity.decaf", false)); }
+END_TEST
+
+START_TEST (B_phase_report_json)
+{ ck_assert (valid_phase_report("-ftime-report -fmem-report -freport-format=json inputs/sanity.decaf", true)); }
+END_TEST
+
+TEST_PROGRAM_WITH_PASSES(B_passes_O0, "regalloc", 17, OPT_PROGRAM)
+TEST_PROGRAM_WITH_PASSES(B_passes_O2, "fold-constants,fuse-branches,scaled-index,remove-jumps,regalloc", 17, OPT_PROGRAM)
+TEST_PROGRAM_WITH_PASSES(B_passes_no_regalloc, "fuse-branches,scaled-index", 17, OPT_PROGRAM)
+// Array store whose index is spilled across the call and reloaded into the
+// same instruction as the stored value
+#define SPILLED_INDEX_PROGRAM \
+        "int a[4]; " \
+        "def int f(int x, int y) { return x + y; } " \
+        "def int main() { " \
+        "  int i; int s; i = 0; s = 5; " \
+        "  while (i < 4) { a[i] = f(i, 5) * 2; i = i + 1; } " \
+        "  i = 0; " \
+        "  while (i < 4) { s = s + a[i]; i = i + 1; } " \
+        "  return s; }"
+TEST_PROGRAM_WITH_PASSES(B_passes_spilled_index, "regalloc", 57, SPILLED_INDEX_PROGRAM)
+TEST_PROGRAM_WITH_PASSES(B_passes_spilled_index_scaled, "scaled-index,regalloc", 57, SPILLED_INDEX_PROGRAM)
+TEST_PROGRAM_WITH_PASSES(B_passes_spilled_index_O2, "fold-constants,fuse-branches,scaled-index,remove-jumps,regalloc", 57,
+        SPILLED_INDEX_PROGRAM)
+TEST_PROGRAM_WITH_PASSES(B_passes_fold_no_overflow, "fold-constants,regalloc", 0,
+        "def int main() { if (2147483647 + 1 > 0) { return 0; } return 1; }")
+TEST_PROGRAM_WITH_PASSES(B_passes_ast_after_iloc, "regalloc,fold-constants", ERROR_RETURN_CODE,
+        "def int main() { return 0; }")
+
 #endif
 
 /**
@@ -140,6 +181,17 @@ void public_tests (Suite *s)
         TEST(B_func_call4);
 
         TEST(B_recursion);
+
+        TEST(B_phase_report_text);
+        TEST(B_phase_report_json);
+        TEST(B_passes_O0);
+        TEST(B_passes_O2);
+        TEST(B_passes_no_regalloc);
+        TEST(B_passes_spilled_index);
+        TEST(B_passes_spilled_index_scaled);
+        TEST(B_passes_spilled_index_O2);
+        TEST(B_passes_fold_no_overflow);
+        TEST(B_passes_ast_after_iloc);
         // TEST(B_recursion1);
         // TEST(B_recursion2);
 
@@ -1,3 +1,5 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "testsuite.h"
 
 jmp_buf decaf_error;
@@ -25,6 +27,7 @@ int run_program_with_allocation (char* text, int num_registers)
     NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
     NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
     NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(ResolveSymbolsVisitor_new(), tree);
     ErrorList* errors = analyze(tree);
     if (!ErrorList_is_empty(errors)) {
         /* static analysis error; return code */
@@ -45,6 +48,39 @@ int run_program_with_allocation (char* text, int num_registers)
     return run_simulator(iloc, false);
 }
 
+int run_program_with_passes (char* text, const char* passes)
+{
+    ASTNode* tree = NULL;
+    if (setjmp(decaf_error) == 0) {
+        /* no error */
+        tree = parse(lex(text));
+    } else {
+        /* parsing error; return code */
+        return ERROR_RETURN_CODE;
+    }
+    NodeVisitor_traverse_and_free(SetParentVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(CalcDepthVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(BuildSymbolTablesVisitor_new(), tree);
+    NodeVisitor_traverse_and_free(ResolveSymbolsVisitor_new(), tree);
+    ErrorList* errors = analyze(tree);
+    if (!ErrorList_is_empty(errors)) {
+        /* static analysis error; return code */
+        return ERROR_RETURN_CODE;
+    }
+    NodeVisitor_traverse_and_free(AllocateSymbolsVisitor_new(), tree);
+    PassManager* pm = PassManager_new();
+    if (!PassManager_add_list(pm, passes)) {
+        /* invalid pipeline; return code */
+        PassManager_free(pm);
+        return ERROR_RETURN_CODE;
+    }
+    PassManager_run_ast(pm, tree);
+    InsnList* iloc = generate_code(tree);
+    PassManager_run_iloc(pm, iloc);
+    PassManager_free(pm);
+    return run_simulator(iloc, false);
+}
+
 int run_main(char* text)
 {
     char code[MAX_FILE_SIZE+128];
@@ -80,6 +116,68 @@ int run_bool_expression_with_allocation(char* text, int num_registers)
     return run_program_with_allocation(code, num_registers);
 }
 
+/**
+ * @brief Phases that the driver reports at -O0 (in order), followed by the total
+ */
+const char* report_phase_names[] = {
+    "lex", "parse", "setup-tree", "analyze", "allocate-symbols",
+    "generate-code", "regalloc", "simulate", "TOTAL"
+};
+
+bool valid_phase_report (const char* args, bool json)
+{
+    /* run the driver and keep only its standard error (the report) */
+    char command[256];
+    snprintf(command, sizeof(command), "%s %s 2>&1 >/dev/null", DRIVER, args);
+    FILE* output = popen(command, "r");
+    if (output == NULL) {
+        return false;
+    }
+    char report[8192];
+    size_t length = fread(report, 1, sizeof(report) - 1, output);
+    report[length] = '\0';
+    if (pclose(output) != 0) {
+        return false;
+    }
+
+    /* memory statistics are only recorded in some builds */
+    bool mem = (json ? strstr(report, "{\"memory_tracking\": true, \"phases\": [") != NULL
+                     : strstr(report, "ALLOC (bytes)") != NULL);
+    if (json && !mem && strstr(report, "{\"memory_tracking\": false, \"phases\": [") != report) {
+        return false;
+    }
+
+    /* every phase appears once, in order, with non-negative numbers */
+    const char* p = report;
+    int num_phases = sizeof(report_phase_names) / sizeof(report_phase_names[0]);
+    for (int i = 0; i < num_phases; i++) {
+        char pattern[64];
+        snprintf(pattern, sizeof(pattern), (json ? "{\"name\": \"%s\"" : "\n%s "),
+                report_phase_names[i]);
+        p = strstr(p, pattern);
+        if (p == NULL) {
+            return false;
+        }
+        double wall_ms, cpu_ms;
+        size_t bytes = 0, allocs = 0;
+        long peak = 0;
+        int n = (json ? sscanf(p + strlen(pattern),
+                        ", \"wall_ms\": %lf, \"cpu_ms\": %lf, \"allocated_bytes\": %zu,"
+                        " \"allocations\": %zu, \"peak_bytes\": %ld}",
+                        &wall_ms, &cpu_ms, &bytes, &allocs, &peak)
+                      : sscanf(p + strlen(pattern), "%lf %lf %zu %zu %ld",
+                        &wall_ms, &cpu_ms, &bytes, &allocs, &peak));
+        if (n != (mem ? 5 : 2) || wall_ms < 0.0 || cpu_ms < 0.0) {
+            return false;
+        }
+        if (mem && (allocs == 0 || bytes == 0 || peak <= 0)) {
+            return false;
+        }
+        p += strlen(pattern);
+    }
+    return true;
+}
+
 extern void public_tests (Suite *s);
 extern void private_tests (Suite *s);
 
@@ -17,6 +17,7 @@
 #include "p3-analysis.h"
 #include "p4-codegen.h"
 #include "p5-regalloc.h"
+#include "passes.h"
 
 /**
  * @brief Number of physical registers for most tests
@@ -77,6 +78,13 @@ END_TEST
 { ck_assert_int_eq (run_bool_expression_with_allocation(TEXT, NREGS), RVAL); } \
 END_TEST
 
+/**
+ * @brief Define a test case with an entire program compiled with a custom pass pipeline
+ */
+#define TEST_PROGRAM_WITH_PASSES(NAME,PASSES,RVAL,TEXT) START_TEST (NAME) \
+{ ck_assert_int_eq (run_program_with_passes(TEXT, PASSES), RVAL); } \
+END_TEST
+
 /**
  * @brief Add a test to the test suite
  */
@@ -101,6 +109,16 @@ int run_program (char* text);
  */
 int run_program_with_allocation (char* text, int num_registers);
 
+/**
+ * @brief Run lexer, parser, analysis, and code generation on given program
+ * with a custom pass pipeline (see passes.h)
+ *
+ * @param text Code to lex, parse, analyze, generate, and optimize
+ * @param passes Comma-separated pass names
+ * @returns Return value or @c ERROR_RETURN_CODE if there was an error
+ */
+int run_program_with_passes (char* text, const char* passes);
+
 /**
  * @brief Run lexer, parser, analysis, code generation, and register allocation on given 'main' function
  *
@@ -143,3 +161,22 @@ int run_expression_with_allocation (char* text, int num_registers);
  * @returns Return value or @c ERROR_RETURN_CODE if there was an error
  */
 int run_bool_expression_with_allocation (char* text, int num_registers);
+
+/**
+ * @brief Path to the compiler driver (relative to the tests folder)
+ */
+#define DRIVER "../decaf"
+
+/**
+ * @brief Run the compiler driver with a phase report and check the report
+ *
+ * Verifies that every phase (see @c report_phase_names) and the total appear
+ * in order with valid wall and CPU times and, if memory statistics are
+ * available in this build, a non-zero number of allocations, allocated
+ * bytes, and peak bytes.
+ *
+ * @param args Command-line arguments (report flags and input file)
+ * @param json True if the report is requested with @c -freport-format=json
+ * @returns True if and only if the driver succeeded and the report is valid
+ */
+bool valid_phase_report (const char* args, bool json);